@@ -16,20 +16,34 @@
 #ifndef INCLUDED_DebugSerial_h
 #define INCLUDED_DebugSerial_h
 #include <Arduino.h>
+#include "profile.h"
 
 // This header file allows enabling or disabling all of the Serial.print() and Serial.println() calls
 // in the station_buzzers sketch by whichever of the following two #define/#undef lines is *last*
 #define WANT_REAL_SERIAL
 #undef WANT_REAL_SERIAL
 
+// With WANT_VCD_TRACE enabled, the serial port carries a VCD waveform trace of the stations (see
+// trace.h) and the debug messages are turned off, since they would corrupt the trace.
+#define WANT_VCD_TRACE
+#undef WANT_VCD_TRACE
+
 
 // The 32u4 based Leonardo boards have "Serial" defined in a way that communicates directly over USB
 // and leaves the D0/D1 pins completely available.
-#ifdef ARDUINO_AVR_LEONARDO
+#if defined(ARDUINO_AVR_LEONARDO) && !defined(WANT_VCD_TRACE)
 #define WANT_REAL_SERIAL
 #endif
 
-#ifdef WANT_REAL_SERIAL
+// With WANT_PROFILE enabled (see profile.h) the port is opened as usual, but the debug messages
+// are turned off: at 9600 baud they would stall the very passes being timed.
+#if defined(WANT_REAL_SERIAL) && defined(WANT_PROFILE)
+
+#define DebugSerial_begin(baud_rate) Serial.begin(baud_rate)
+#define DebugSerial_print(...) do { } while (0)
+#define DebugSerial_println(...) do { } while (0)
+
+#elif defined(WANT_REAL_SERIAL)
 
 #define DebugSerial_begin(baud_rate) Serial.begin(baud_rate)
 #define DebugSerial_print(...) Serial.print(__VA_ARGS__)
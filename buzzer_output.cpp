@@ -0,0 +1,55 @@
+// buzzer_output.cpp -- drives all of the buzzer outputs with one port write per tick
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+#include "buzzer_output.h"
+
+uint8_t buzzer_port_levels[buzzer_num_ports];
+
+// The buzzer pins on each port; the other bits of the port are left alone by the commit
+static uint8_t buzzer_port_masks[buzzer_num_ports];
+
+uint8_t
+buzzer_output_setup(uint8_t pin, uint8_t level, uint8_t *bit_mask)
+{
+  const uint8_t port = digitalPinToPort(pin);
+  *bit_mask = digitalPinToBitMask(pin);
+  if ((port == NOT_A_PORT) || (port >= buzzer_num_ports))
+    return NOT_A_PORT;
+
+  // digitalWrite() also turns off any PWM timer driving the pin, which the commit won't do
+  pinMode(pin, OUTPUT);
+  digitalWrite(pin, level);
+
+  buzzer_port_masks[port] |= *bit_mask;
+  buzzer_output_set(port, *bit_mask, level == HIGH);
+  return port;
+}
+
+void
+buzzer_output_commit()
+{
+  for (uint8_t port = 0; port < buzzer_num_ports; port++) {
+    const uint8_t mask = buzzer_port_masks[port];
+    if (mask == 0)
+      continue;
+
+    // Interrupt handlers may also write to this port, so keep the read-modify-write atomic
+    volatile uint8_t *out = portOutputRegister(port);
+    const uint8_t old_sreg = SREG;
+    cli();
+    *out = (*out & ~mask) | (buzzer_port_levels[port] & mask);
+    SREG = old_sreg;
+  }
+}
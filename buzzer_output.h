@@ -0,0 +1,47 @@
+// buzzer_output.h -- drives all of the buzzer outputs with one port write per tick
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+#ifndef INCLUDED_buzzer_output
+#define INCLUDED_buzzer_output
+
+#include <Arduino.h>
+
+// The MorseBuzzers don't write their pins themselves. Instead each one sets or clears its bit in
+// buzzer_port_levels[], and once per pass through run_station_states() buzzer_output_commit()
+// copies those bits to the PORTx registers, one masked write per port. All the edges of one
+// tick come out together, and a buzzer edge costs a couple of instructions instead of a
+// digitalWrite().
+//
+// The arrays are indexed by the Arduino port number from digitalPinToPort(); PA through PL are
+// 1 to 12.
+static const uint8_t buzzer_num_ports = 13;
+extern uint8_t buzzer_port_levels[buzzer_num_ports];
+
+// Make pin an output driven by the commit, initially at level, and return its port number
+// (NOT_A_PORT for an invalid pin). *bit_mask is set to the pin's bit within the port.
+uint8_t buzzer_output_setup(uint8_t pin, uint8_t level, uint8_t *bit_mask);
+
+inline void
+buzzer_output_set(uint8_t port, uint8_t bit_mask, bool high)
+{
+  if (high)
+    buzzer_port_levels[port] |= bit_mask;
+  else
+    buzzer_port_levels[port] &= ~bit_mask;
+}
+
+void buzzer_output_commit();
+
+#endif
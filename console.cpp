@@ -0,0 +1,112 @@
+// console.cpp -- a small command console on the serial port
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+
+#include "console.h"
+#include "station_info.h"
+#include "station_states.h"
+#include "memory_stats.h"
+#include "morse_injection.h"
+
+#ifdef WANT_REAL_SERIAL
+
+// Longer commands are cut short; only the first letter matters today
+static const uint8_t console_line_length = 15;
+static char          console_line[console_line_length + 1];
+static uint8_t       console_line_used = 0;
+
+// Each line of a report waits until the transmit buffer has (nearly) drained, so that the
+// console never queues more than one line ahead of the state machine's own debug messages.
+// A debug message that follows a line still waits for it (see console.h). The memory report
+// is a single line of about 100 characters, so it also blocks for the part that doesn't fit.
+static const int console_tx_room = 63;
+
+// Reads whatever has arrived, and returns true once a whole command line is in console_line.
+// Bytes of a '>' line go straight to the Morse injector instead.
+static bool
+read_line()
+{
+  while (Serial.available() > 0) {
+    const char c = Serial.peek();
+    if (morse_injection_receiving() || ((c == '>') && (console_line_used == 0))) {
+      // If the injection buffer is full, leave the rest waiting in the serial buffer
+      if (!morse_injection_receive(c))
+        return false;
+      Serial.read();
+      continue;
+    }
+
+    Serial.read();
+    if ((c == '\r') || (c == '\n')) {
+      // Skip blank lines, including the second half of a CR LF
+      if (console_line_used == 0)
+        continue;
+      console_line[console_line_used] = '\0';
+      console_line_used = 0;
+      return true;
+    }
+    if (console_line_used < console_line_length)
+      console_line[console_line_used++] = c;
+  }
+  return false;
+}
+
+static inline bool
+tx_drained()
+{
+  return Serial.availableForWrite() >= console_tx_room;
+}
+
+bool
+run_console(Task_Context *ctx)
+{
+  // The task returns at every wait, so anything kept across one has to be static
+  static uint8_t ii;
+
+  TASK_BEGIN(ctx);
+  while (1) {
+    TASK_WAIT_UNTIL(ctx, read_line());
+
+    if ((console_line[0] == 'S') || (console_line[0] == 's')) {
+      for (ii = 0; ii < num_stations; ii++) {
+        TASK_WAIT_UNTIL(ctx, tx_drained());
+        Station_Info * const station = &stations[ii];
+        Serial.print(F("STATION "));
+        Serial.print(station->station_code());
+        Serial.print(F(" "));
+        Serial.println(state_names[station->state()]);
+      }
+    } else if ((console_line[0] == 'T') || (console_line[0] == 't')) {
+      for (ii = 0; ii < num_tasks; ii++) {
+        TASK_WAIT_UNTIL(ctx, tx_drained());
+        Serial.print(F("TASK "));
+        Serial.print(tasks[ii].name_);
+        Serial.print(F(" max_step_us="));
+        Serial.print(tasks[ii].max_step_usec_);
+        Serial.print(F(" missed_deadlines="));
+        Serial.println(tasks[ii].missed_deadlines_);
+      }
+    } else if ((console_line[0] == 'M') || (console_line[0] == 'm')) {
+      TASK_WAIT_UNTIL(ctx, tx_drained());
+      report_memory_stats();
+    } else {
+      TASK_WAIT_UNTIL(ctx, tx_drained());
+      Serial.println(F("commands: S stations, T tasks, M memory, >text"));
+    }
+  }
+  TASK_END(ctx);
+}
+
+#endif
@@ -0,0 +1,55 @@
+// console.h -- a small command console on the serial port
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+
+#ifndef INCLUDED_console
+#define INCLUDED_console
+
+#include "tasks.h"
+#include "DebugSerial.h"
+
+// With WANT_REAL_SERIAL enabled in DebugSerial.h, the serial port also takes one-letter
+// commands, one per line:
+//
+//   S   the state of every station, e.g. "STATION BD RING_WAITING"
+//   T   each task's longest stretch between yields and how often it missed its deadline
+//   M   a memory report (see memory_stats.h)
+//   ?   a list of the commands
+//
+// and a line starting with '>' is handed to the Morse injector (see morse_injection.h). The
+// console runs as a task (see tasks.h): it uses no heap, keeps the command in a small fixed
+// buffer, and waits for the serial transmit buffer to drain before each line it prints, so a
+// long report never piles up ahead of the stations.
+//
+// That doesn't make the console free. With the debug messages on (that is, without
+// WANT_PROFILE; see DebugSerial.h), a state change that comes right after a console line finds
+// the line still in the 64 byte buffer, and its own debug message (up to 56 bytes) waits in
+// Serial.print() for the room. No console line fits alongside one, so waiting for more room
+// wouldn't help: the console adds up to one line-time of latency to run_station_states(),
+// about 55 msec for the longest T line at 9600 baud. host/console_load measures the worst gap
+// between station ticks at 95.9 msec with no commands and 118.9 msec with S and T every 50
+// msec. With the debug messages off, the console adds nothing.
+
+#ifdef WANT_REAL_SERIAL
+
+bool run_console(Task_Context *ctx);
+
+#else
+
+inline bool run_console(Task_Context *ctx) { return false; }
+
+#endif
+
+#endif
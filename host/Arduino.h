@@ -0,0 +1,133 @@
+// Arduino.h -- just enough of the Arduino core to build the sketch on a PC
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+#ifndef INCLUDED_host_Arduino_h
+#define INCLUDED_host_Arduino_h
+
+// The sketch is built against this header by the programs in this directory (see the Makefile).
+// It models an Uno: pins 0-7 are on port D, 8-13 on port B and 14-19 (A0-A5) on port C, while
+// A6 and A7 are analog inputs only. Input levels, output registers and the clock all live in
+// sim.h, where the simulators can drive them.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "avr/io.h"
+#include "avr/pgmspace.h"
+
+typedef bool    boolean;
+typedef uint8_t byte;
+
+#define HIGH         1
+#define LOW          0
+#define INPUT        0
+#define OUTPUT       1
+#define INPUT_PULLUP 2
+
+#define DEC 10
+#define HEX 16
+
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A4 18
+#define A5 19
+#define A6 20
+#define A7 21
+#define NUM_DIGITAL_PINS 22
+
+#define NOT_A_PORT 0
+#define PB 2
+#define PC 3
+#define PD 4
+
+#define digitalPinToPort(p) \
+  ((uint8_t)((p) < 8 ? PD : (p) < 14 ? PB : (p) < 20 ? PC : NOT_A_PORT))
+#define digitalPinToBitMask(p) \
+  ((uint8_t)(1 << ((p) < 8 ? (p) : (p) < 14 ? (p) - 8 : (p) < 20 ? (p) - 14 : 0)))
+#define portOutputRegister(port) (&sim_port[port])
+
+#define bit(b) (1UL << (b))
+
+// There are no interrupts on the host; the simulators call ISRs themselves if they want them
+#define cli()          do { } while (0)
+#define sei()          do { } while (0)
+#define interrupts()   do { } while (0)
+#define noInterrupts() do { } while (0)
+#define ISR(vector)    extern "C" void vector(void)
+
+extern volatile uint8_t sim_port[PD + 1];
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+int  digitalRead(uint8_t pin);
+int  analogRead(uint8_t pin);
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long msec);
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+// F() strings are ordinary strings here, since the host has a single address space
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+
+class Print {
+ public:
+  virtual ~Print() { }
+  virtual size_t write(uint8_t c) = 0;
+  size_t write(const uint8_t *buffer, size_t size);
+  size_t write(const char *str);
+
+  size_t print(const char *str);
+  size_t print(const __FlashStringHelper *str);
+  size_t print(char c);
+  size_t print(unsigned char n, int base = DEC);
+  size_t print(int n, int base = DEC);
+  size_t print(unsigned n, int base = DEC);
+  size_t print(long n, int base = DEC);
+  size_t print(unsigned long n, int base = DEC);
+
+  size_t println();
+  template <class T> size_t println(T value) { size_t n = print(value); return n + println(); }
+  template <class T> size_t println(T value, int base) { size_t n = print(value, base); return n + println(); }
+};
+
+// A serial port whose bytes come from and go to the simulator (see sim.h)
+class HardwareSerial : public Print {
+ public:
+  HardwareSerial(int port) : port_(port) { }
+  void begin(unsigned long baud);
+  int available();
+  int peek();
+  int read();
+  int availableForWrite();
+  void flush();
+  size_t write(uint8_t c);
+  using Print::write;
+  operator bool() { return true; }
+ private:
+  int port_;
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+
+#endif
@@ -0,0 +1,52 @@
+#!/bin/sh
+# assemble_paint_stack.sh -- assemble memory_stats.cpp's start-up code for each AVR board
+#   Copyright (c) 2026, the station_buzzers contributors
+#
+# This program is free software; you can redistribute it and/or modify it under the terms of
+# the GNU General Public License as published by the Free Software Foundation; either version
+# 2 of the License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+# without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# See the GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License along with this program;
+# if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+# Boston, MA 02110-1301, USA.
+#
+# usage: assemble_paint_stack.sh
+#
+# The host build leaves out paint_stack()'s naked .init3 assembler, so this takes the asm
+# statement out of memory_stats.cpp, fills in the paint byte and each board's RAMEND, and runs it
+# through avr-as (from avr-gcc) or llvm-mc, whichever is installed. It only shows the code
+# assembles; what it does on a board is for the MEMORY report there to show. With neither
+# assembler to hand it says so and succeeds, so that "make check" still runs.
+
+cd "$(dirname "$0")/.." || exit 2
+
+if command -v avr-as > /dev/null; then
+  assemble() { avr-as -mmcu="$1" -o /dev/null; }
+elif command -v llvm-mc > /dev/null && llvm-mc --version | grep -q avr; then
+  assemble() { llvm-mc -triple=avr -mcpu="$1" -filetype=obj -o /dev/null; }
+else
+  echo "assemble_paint_stack.sh: no AVR assembler (avr-as or llvm-mc), skipped"
+  exit 0
+fi
+
+paint=$(sed -n 's/^#define STACK_PAINT \(0x[0-9a-fA-F]*\).*/\1/p' memory_stats.cpp)
+[ -n "$paint" ] || { echo "assemble_paint_stack.sh: no STACK_PAINT in memory_stats.cpp"; exit 2; }
+
+status=0
+for board in atmega328p:0x8ff atmega32u4:0xaff atmega2560:0x21ff; do
+  mcu=${board%:*}
+  ramend=${board#*:}
+  {
+    echo '    .section .init3,"ax",@progbits'
+    echo 'paint_stack:'
+    sed -n '/__asm__ __volatile__ (/,/);/p' memory_stats.cpp | sed -e '1d' -e '$d' \
+      -e 's/^ *"//' -e 's/\\n"$//' \
+      -e "s/\" STACK_PAINT_XSTR(STACK_PAINT) \"/$paint/g" \
+      -e "s/\" STACK_PAINT_XSTR(RAMEND) \"/$ramend/g"
+  } | assemble "$mcu" && echo "paint_stack assembles for $mcu" || status=1
+done
+exit $status
@@ -0,0 +1,52 @@
+// avr/io.h -- the few AVR registers the sketch touches, as plain variables
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+#ifndef INCLUDED_host_avr_io_h
+#define INCLUDED_host_avr_io_h
+
+#include <stdint.h>
+
+#define F_CPU  16000000UL
+
+// The SRAM above the static data, from __heap_start to RAMEND, is sim_sram (see sim.h), so
+// RAMEND and the stack pointer SP are addresses in it
+static const int sim_sram_bytes = 1280;
+extern uint8_t   sim_sram[sim_sram_bytes];
+extern uintptr_t sim_stack_pointer;
+#define RAMEND (reinterpret_cast<uintptr_t>(sim_sram) + sim_sram_bytes - 1)
+#define SP     sim_stack_pointer
+
+#define _BV(b) (1 << (b))
+
+extern volatile uint8_t SREG;
+
+// Timer1, used by the status panel
+extern volatile uint8_t  TCCR1A, TCCR1B, TIMSK1;
+extern volatile uint16_t OCR1A;
+#define WGM12  3
+#define CS10   0
+#define CS11   1
+#define CS12   2
+#define OCIE1A 1
+
+// Timer2, used by the sounder
+extern volatile uint8_t TCCR2A, TCCR2B, TIMSK2, OCR2B;
+#define TCCR2A TCCR2A
+#define WGM20  0
+#define COM2B1 5
+#define CS20   0
+#define TOIE2  0
+
+#endif
@@ -0,0 +1,29 @@
+// avr/pgmspace.h -- program memory is ordinary memory on the host
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+#ifndef INCLUDED_host_avr_pgmspace_h
+#define INCLUDED_host_avr_pgmspace_h
+
+#include <stdint.h>
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(address) (*reinterpret_cast<const uint8_t *>(address))
+#define pgm_read_word(address) (*(address))
+
+// There is no flash image on the host, so a flash address (and the size of the program) is 0
+#define pgm_get_far_address(var) 0UL
+
+#endif
@@ -0,0 +1,44 @@
+#!/bin/sh
+# compare_edges.sh -- compare the buzzer edges of this tree with an older commit
+#   Copyright (c) 2026, the station_buzzers contributors
+#
+# This program is free software; you can redistribute it and/or modify it under the terms of
+# the GNU General Public License as published by the Free Software Foundation; either version
+# 2 of the License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+# without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# See the GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License along with this program;
+# if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+# Boston, MA 02110-1301, USA.
+#
+# usage: compare_edges.sh <commit>
+#
+# Checks out <commit> in a scratch worktree, builds this copy of the host harness against both
+# trees, runs edges.cpp's scripted session on each and diffs the output. An empty diff means
+# the two builds drive the buzzers identically, edge for edge.
+
+set -e
+commit=${1:?usage: compare_edges.sh <commit>}
+here=$(cd "$(dirname "$0")" && pwd)
+scratch=$(mktemp -d)
+trap 'git -C "$here" worktree remove --force "$scratch/old" >/dev/null 2>&1; rm -rf "$scratch"' EXIT
+
+git -C "$here" worktree add --detach "$scratch/old" "$commit" >/dev/null
+rm -rf "$scratch/old/host"
+mkdir "$scratch/old/host"
+(cd "$here" && cp -r Arduino.h avr sim.h sim.cpp configure_sketch.sh Makefile edges.cpp "$scratch/old/host/")
+
+make -s -C "$here" edges >/dev/null
+make -s -C "$scratch/old/host" edges >/dev/null
+"$here"/build/edges > "$scratch/new.txt"
+"$scratch"/old/host/build/edges > "$scratch/old.txt"
+
+echo "this tree: $(tail -1 "$scratch/new.txt"), $commit: $(tail -1 "$scratch/old.txt")"
+if diff "$scratch/old.txt" "$scratch/new.txt"; then
+  echo "identical"
+else
+  exit 1
+fi
@@ -0,0 +1,56 @@
+#!/bin/sh
+# configure_sketch.sh -- copy the sketch into a host build directory, configured
+#   Copyright (c) 2026, the station_buzzers contributors
+#
+# This program is free software; you can redistribute it and/or modify it under the terms of
+# the GNU General Public License as published by the Free Software Foundation; either version
+# 2 of the License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+# without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# See the GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License along with this program;
+# if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+# Boston, MA 02110-1301, USA.
+#
+# usage: configure_sketch.sh <build dir> <table> [WANT_FEATURE ...]
+#
+# Copies the sketch sources into <build dir> (the .ino as station_buzzers.cpp), selects the
+# named station table (e.g. DAVID_PARKS) and turns on each WANT_ feature by deleting its #undef
+# line, just as you would when editing the sketch by hand. The sources are only rewritten when
+# they change, so make doesn't rebuild everything every time.
+
+set -e
+dir=$1
+table=$2
+shift 2
+
+here=$(dirname "$0")
+sketch=$here/..
+tmp=$dir/.configure
+rm -rf "$tmp"
+mkdir -p "$tmp"
+
+cp "$sketch"/*.h "$sketch"/*.cpp "$tmp"/
+cp "$sketch"/station_buzzers.ino "$tmp"/station_buzzers.cpp
+
+if ! grep -q "^#undef ${table}_TABLE\$\|^#define ${table}_TABLE\$" "$tmp"/station_buzzers.cpp; then
+  echo "configure_sketch.sh: no station table named $table" >&2
+  exit 1
+fi
+sed -i -e 's/^#define \(.*\)_TABLE$/#undef \1_TABLE/' \
+       -e "s/^#undef ${table}_TABLE\$/#define ${table}_TABLE/" "$tmp"/station_buzzers.cpp
+
+for feature in "$@"; do
+  sed -i "/^#undef ${feature}\$/d" "$tmp"/*.h "$tmp"/*.cpp
+done
+
+for file in "$dir"/*.h "$dir"/*.cpp; do
+  [ -e "$file" ] && [ ! -e "$tmp/$(basename "$file")" ] && rm -f "$file" "${file%.cpp}.o"
+done
+for file in "$tmp"/*; do
+  name=$(basename "$file")
+  cmp -s "$file" "$dir/$name" || cp "$file" "$dir/$name"
+done
+rm -rf "$tmp"
@@ -0,0 +1,104 @@
+// console_load.cpp -- worst station tick latency with the serial console under load
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+// Runs the sketch with WANT_REAL_SERIAL at 9600 baud for ten simulated minutes of random calls
+// and answers, and reports the longest gap between the starts of two loop() passes -- the worst
+// delay in servicing the stations. Three runs:
+//
+//   quiet       no console commands; only the state machine's own debug messages
+//   console     "S" and "T" commands sent every 50 msec
+//   unchecked   the same, but availableForWrite() always claims an empty buffer, so the console
+//               prints as if it didn't wait for the transmit buffer to drain
+//
+// The serial stand-in blocks a write to a full 64 byte buffer the way HardwareSerial does.
+
+#include "sim.h"
+#include "station_info.h"
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+static const unsigned long long run_micros = 600000000ULL;
+static const unsigned pass_usec = 100;
+static const unsigned long command_usec = 50000;
+
+static bool send_commands;
+static bool room_lies;
+
+struct Random {
+  uint32_t state;
+  Random(uint32_t seed) : state(seed) { }
+  uint32_t below(uint32_t n) { state ^= state << 13; state ^= state >> 17; state ^= state << 5; return state % n; }
+};
+
+static int
+run()
+{
+  sim_reset(1);
+  sim_serial[0].tx_baud = 9600;
+  sim_serial[0].tx_room_lies = room_lies;
+  setup();
+
+  std::vector<uint8_t> pins;
+  for (int ii = 0; ii < num_stations; ii++) {
+    if (stations[ii].station_type_ != STATION_AMBIENCE) {
+      pins.push_back(stations[ii].called_pin_);
+      pins.push_back(stations[ii].off_hook_pin_);
+    }
+  }
+
+  Random random(7);
+  const char * const commands[] = { "S\n", "T\n" };
+  const unsigned long long start = sim_micros;
+  unsigned long long next_command = start, next_change = start, last_pass = 0, worst = 0;
+  unsigned commands_sent = 0;
+
+  while (sim_micros - start < run_micros) {
+    if (send_commands && (sim_micros >= next_command)) {
+      sim_serial_send(0, commands[commands_sent++ % 2]);
+      next_command = sim_micros + command_usec;
+    }
+    if (sim_micros >= next_change) {
+      const uint8_t pin = pins[random.below(pins.size())];
+      sim_input[pin] = !sim_input[pin];
+      next_change = sim_micros + 200000 + random.below(2000000);
+    }
+
+    if (last_pass && (sim_micros - last_pass > worst))
+      worst = sim_micros - last_pass;
+    last_pass = sim_micros;
+    loop();
+    sim_micros += pass_usec;
+  }
+
+  printf("%-9s worst gap between station ticks %6.1f msec, %zu bytes sent, %lu command bytes dropped\n",
+         !send_commands ? "quiet" : room_lies ? "unchecked" : "console", worst / 1000.0,
+         sim_serial[0].tx.size(), sim_serial[0].rx_dropped);
+  return 0;
+}
+
+int
+main()
+{
+  printf("table %s, 9600 baud, %llu simulated seconds\n", station_table_name, run_micros / 1000000);
+  send_commands = false;
+  room_lies = false;
+  bool ok = sim_run_child(run);
+  send_commands = true;
+  ok = ok && sim_run_child(run);
+  room_lies = true;
+  ok = ok && sim_run_child(run);
+  return ok ? 0 : 1;
+}
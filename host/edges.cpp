@@ -0,0 +1,82 @@
+// edges.cpp -- prints every buzzer edge of a scripted session
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+// Plays a fixed 130 second session into the sketch -- four stations called, answers, hang-ups,
+// and whatever the ambience station does meanwhile -- and prints "<msec> <pin> <level>" for
+// every change on a buzzer pin, followed by the number of edges. Since the run is exactly
+// repeatable, two builds of the sketch that drive the buzzers the same way print the same
+// lines; compare_edges.sh runs it against an older commit and diffs the two.
+
+#include "sim.h"
+#include "station_info.h"
+#include <stdio.h>
+
+struct Input_Change {
+  unsigned long msec;   // after setup()
+  uint8_t       pin;
+  uint8_t       level;
+};
+
+// For the DAVID_PARKS table: called inputs are A0-A4, off_hook inputs 2-6, all active LOW
+static const Input_Change session[] = {
+  {  1000, A0, LOW  },   // ND called
+  {  1500, A2, LOW  },   // KY called
+  {  2000, A3, LOW  },   // CO called
+  {  9000, 3,  LOW  },   // GE picks up to talk
+  { 12000, A0, HIGH },   // ND's caller gives up
+  { 12100, 3,  HIGH },   // GE hangs up
+  { 20000, A4, LOW  },   // P called
+  { 40000, A2, HIGH },
+  { 41000, A3, HIGH },
+  { 45000, A4, HIGH },
+};
+static const unsigned long session_msec = 130000;
+static const unsigned pass_usec = 137;
+
+static bool last_level[NUM_DIGITAL_PINS];
+static unsigned long long start_micros;
+static unsigned edges = 0;
+
+static void
+print_edges()
+{
+  for (int ii = 0; ii < num_stations; ii++) {
+    const uint8_t pin = stations[ii].buzzer_pin_;
+    const bool level = sim_output(pin);
+    if (level != last_level[pin]) {
+      printf("%llu %d %d\n", (sim_micros - start_micros) / 1000, pin, level);
+      last_level[pin] = level;
+      edges++;
+    }
+  }
+}
+
+int
+main()
+{
+  sim_reset(1);
+  setup();
+  for (int ii = 0; ii < num_stations; ii++)
+    last_level[stations[ii].buzzer_pin_] = sim_output(stations[ii].buzzer_pin_);
+
+  start_micros = sim_micros;
+  for (size_t ii = 0; ii < sizeof(session) / sizeof(session[0]); ii++) {
+    sim_run_until(start_micros + 1000ULL * session[ii].msec, pass_usec, print_edges);
+    sim_input[session[ii].pin] = session[ii].level;
+  }
+  sim_run_until(start_micros + 1000ULL * session_msec, pass_usec, print_edges);
+  printf("%u edges\n", edges);
+  return 0;
+}
@@ -0,0 +1,179 @@
+// inject.cpp -- checks Morse text injected over the serial port
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+// Sends '>' lines to the sketch built with WANT_MORSE_INJECTION and checks what the first
+// ambience station buzzes, and the XON/XOFF flow control. The lines arrive at 9600 baud into
+// the 64 byte receive buffer, which drops what arrives while it is full, as on a board:
+//
+//   - a short line plays exactly the elements of its text
+//   - a 100 character line from a sender that ignores flow control overruns the receive buffer
+//     (behind the 32 character injection buffer), and every character is either played or
+//     counted as dropped
+//   - a 300 character line from a sender that obeys XON/XOFF, and still sends rx_xoff_lag more
+//     characters after each XOFF, loses nothing
+//   - a line that stops arriving halfway is ended after the injection timeout
+//
+// The long lines report the characters per second sustained from the start of the line to its
+// last byte arriving, and the number dropped.
+//
+// Exits non-zero if any check fails.
+
+#include "sim.h"
+#include "station_info.h"
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+static const char XON  = 0x11;
+static const char XOFF = 0x13;
+static const unsigned pass_usec = 200;
+static const unsigned long baud = 9600;
+static const unsigned xoff_lag = 16;      // a 16550 UART's transmit FIFO
+
+static Station_Info *ambience = 0;
+static bool          was_buzzing = false;
+static unsigned long long buzz_start;
+static std::vector<unsigned> buzzes;   // length of each element played, msec
+static unsigned long long line_start;
+
+static void
+watch_buzzer()
+{
+  const bool buzzing = sim_output(ambience->buzzer_pin_) == (ambience->buzzer_active_ == HIGH);
+  if (buzzing && !was_buzzing)
+    buzz_start = sim_micros;
+  if (!buzzing && was_buzzing)
+    buzzes.push_back((sim_micros - buzz_start + 500) / 1000);
+  was_buzzing = buzzing;
+}
+
+// Starts the board, sends the text once it has booted, and waits for it to finish playing
+static void
+play(const std::string &text, unsigned long max_msec, bool flow_control = true)
+{
+  sim_reset(1);
+  for (int ii = 0; ii < num_stations; ii++) {
+    if (stations[ii].station_type_ == STATION_AMBIENCE) {
+      ambience = const_cast<Station_Info *>(&stations[ii]);
+      break;
+    }
+  }
+  sim_serial[0].rx_baud = baud;
+  sim_serial[0].rx_xon_xoff = flow_control;
+  sim_serial[0].rx_xoff_lag = xoff_lag;
+  setup();
+  sim_serial[0].tx.clear();
+  const unsigned long long start = sim_micros;
+  sim_serial_send(0, text);
+
+  line_start = start;
+  const unsigned long long until = start + 1000ULL * max_msec;
+  bool started = false;
+  while (sim_micros < until) {
+    loop();
+    watch_buzzer();
+    if (ambience->state() == RING_PLAYING)
+      started = true;
+    else if (started)
+      break;
+    sim_micros += pass_usec;
+  }
+}
+
+static int
+count(const std::string &text, char c)
+{
+  int n = 0;
+  for (size_t ii = 0; ii < text.size(); ii++)
+    n += (text[ii] == c);
+  return n;
+}
+
+static int
+check(bool ok, const char *what)
+{
+  printf("%s: %s\n", ok ? "ok  " : "FAIL", what);
+  return ok ? 0 : 1;
+}
+
+// "SOS 5": S is three dots, O is dot-space-dot, and 5 is three dashes
+static int
+short_line()
+{
+  play(">sos 5\n", 30000);
+  const unsigned expected[] = { 100, 100, 100, 100, 100, 100, 100, 100, 200, 200, 200 };
+  bool same = (buzzes.size() == sizeof(expected) / sizeof(expected[0]));
+  for (size_t ii = 0; same && (ii < buzzes.size()); ii++)
+    same = (buzzes[ii] + 1 >= expected[ii]) && (buzzes[ii] <= expected[ii] + 1);
+  printf("      %zu elements:", buzzes.size());
+  for (size_t ii = 0; ii < buzzes.size(); ii++)
+    printf(" %u", buzzes[ii]);
+  printf("\n");
+  return check(same, "\">sos 5\" plays 8 dots and 3 dashes");
+}
+
+static void
+print_throughput(const std::string &tx)
+{
+  const Sim_Serial &serial = sim_serial[0];
+  printf("      %zu elements, %d XOFF, %d XON, %lu bytes received at %.1f chars/sec sustained, %lu dropped\n",
+         buzzes.size(), count(tx, XOFF), count(tx, XON), serial.rx_received,
+         serial.rx_received / ((serial.rx_last_micros - line_start) / 1e6), serial.rx_dropped);
+}
+
+static int
+overrun_line()
+{
+  play(">" + std::string(100, 'E') + "\n", 120000, false);
+  const std::string &tx = sim_serial[0].tx;
+  print_throughput(tx);
+  const unsigned long dropped = sim_serial[0].rx_dropped;
+  return check(dropped > 0, "100 E's ignoring XOFF overrun the receive buffer") +
+         check((buzzes.size() + dropped >= 100) && (buzzes.size() + dropped <= 101),
+               "every E is played or dropped");
+}
+
+static int
+long_line()
+{
+  play(">" + std::string(300, 'E') + "\n", 300000);
+  const std::string &tx = sim_serial[0].tx;
+  print_throughput(tx);
+  return check((buzzes.size() == 300) && (sim_serial[0].rx_dropped == 0),
+               "300 E's sent obeying XON/XOFF play 300 dots, none dropped") +
+         check((count(tx, XOFF) >= 1) && (count(tx, XOFF) == count(tx, XON)), "every XOFF followed by an XON");
+}
+
+static int
+broken_line()
+{
+  play(">AB", 30000);
+  const unsigned long long ended = sim_micros / 1000;
+  printf("      %zu elements, ring ended at %llu msec\n", buzzes.size(), ended);
+  return check(buzzes.size() == 6, "\">AB\" with no end of line plays A and B") +
+         check(ambience->state() != RING_PLAYING, "the line is ended after the timeout");
+}
+
+int
+main()
+{
+  int failed = 0;
+  failed += !sim_run_child(short_line);
+  failed += !sim_run_child(overrun_line);
+  failed += !sim_run_child(long_line);
+  failed += !sim_run_child(broken_line);
+  printf("%s\n", failed ? "FAILED" : "all passed");
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,148 @@
+// memory_stats_sim.cpp -- exercises WANT_MEMORY_STATS against a simulated heap and stack
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+// Runs the sketch with WANT_MEMORY_STATS, building a heap and a stack in sim_sram by hand (the
+// host sketch uses neither), and checks the 'M' console report and the low-water warning:
+//
+//   - freshly painted, the report shows all of sim_sram free and an empty heap and stack
+//   - with a heap holding two free blocks and a 200 byte stack, every figure in the report,
+//     including the free list walk, is what was built
+//   - when the stack reaches within memory_low_water_bytes of the heap, loop() prints the
+//     warning on its own, once, and free_min stays at that low point after the stack unwinds
+//
+// Exits non-zero if any check fails.
+
+#include "sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+static const unsigned pass_usec = 200;
+
+static int
+check(bool ok, const char *what)
+{
+  printf("%s: %s\n", ok ? "ok  " : "FAIL", what);
+  return ok ? 0 : 1;
+}
+
+static void
+run_msec(unsigned long msec)
+{
+  sim_run_until(sim_micros + 1000ULL * msec, pass_usec);
+}
+
+// Sends the 'M' command and returns the MEMORY line it prints
+static std::string
+memory_report()
+{
+  sim_serial[0].tx.clear();
+  sim_serial_send(0, "M\n");
+  run_msec(100);
+  const std::string &tx = sim_serial[0].tx;
+  const size_t start = tx.find("MEMORY ");
+  if (start == std::string::npos)
+    return "";
+  return tx.substr(start, tx.find('\n', start) - start);
+}
+
+static long
+field(const std::string &line, const char *key)
+{
+  const size_t at = line.find(std::string(" ") + key + "=");
+  return (at == std::string::npos) ? -1 : atol(line.c_str() + at + strlen(key) + 2);
+}
+
+static bool
+fields_are(const std::string &line, long free_now, long free_min, long stack_max, long heap_used,
+           long heap_free_list, long heap_largest_free)
+{
+  printf("      %s\n", line.c_str());
+  return (field(line, "free_now") == free_now) && (field(line, "free_min") == free_min) &&
+         (field(line, "stack_max") == stack_max) && (field(line, "heap_used") == heap_used) &&
+         (field(line, "heap_free_list") == heap_free_list) && (field(line, "heap_largest_free") == heap_largest_free);
+}
+
+// Puts a free block of sz bytes (plus its size word) at offset in sim_sram
+static struct __freelist *
+free_block(size_t offset, size_t sz, struct __freelist *next)
+{
+  struct __freelist * const block = reinterpret_cast<struct __freelist *>(&sim_sram[offset]);
+  block->sz = sz;
+  block->nx = next;
+  return block;
+}
+
+// Moves the stack pointer so that the stack is depth bytes deep, writing over the paint as a
+// real stack would on the way down
+static void
+stack_depth(int depth)
+{
+  for (int ii = 0; ii < depth; ii++)
+    sim_sram[sim_sram_bytes - 1 - ii] = 0;
+  sim_stack_pointer = RAMEND - depth;
+}
+
+static int
+run()
+{
+  int failed = 0;
+  sim_reset(1);
+  setup();
+  run_msec(3000);
+
+  const int all = sim_sram_bytes;
+  failed += check(fields_are(memory_report(), all, all, 0, 0, 0, 0),
+                  "freshly painted: all free, no heap or stack");
+
+  // A 300 byte heap with two free blocks on the list, and a 200 byte stack
+  const int heap = 300, stack = 200;
+  memset(sim_sram, 0, heap);
+  __brkval = reinterpret_cast<char *>(&sim_sram[heap]);
+  __flp = free_block(40, 30, free_block(150, 80, 0));
+  const int free_list = 30 + 80 + 2 * sizeof(size_t), largest = 80 + sizeof(size_t);
+  stack_depth(stack);
+  sim_serial[0].tx.clear();
+  run_msec(2000);
+  failed += check(sim_serial[0].tx.find("WARNING") == std::string::npos, "no warning with 780 bytes free");
+  failed += check(fields_are(memory_report(), all - heap - stack, all - heap - stack, stack,
+                             heap - free_list, free_list, largest),
+                  "heap, free list and stack measured as built");
+
+  // The stack comes within 100 bytes of the heap, then unwinds
+  const int deep = all - heap - 100;
+  stack_depth(deep);
+  sim_serial[0].tx.clear();
+  run_msec(2000);
+  stack_depth(stack);
+  run_msec(3000);
+  const std::string &tx = sim_serial[0].tx;
+  const size_t warning = tx.find("WARNING: low memory, MEMORY ");
+  printf("      %s", (warning == std::string::npos) ? "no warning\n" : tx.substr(warning, tx.find('\n', warning) + 1 - warning).c_str());
+  failed += check((warning != std::string::npos) && (tx.find("WARNING", warning + 1) == std::string::npos) &&
+                  (field(tx.substr(warning), "free_min") == 100),
+                  "low-water warning printed once, by loop() alone");
+  failed += check(field(memory_report(), "free_min") == 100, "free_min stays at the low point");
+
+  printf("%s\n", failed ? "FAILED" : "all passed");
+  return failed ? 1 : 0;
+}
+
+int
+main()
+{
+  return sim_run_child(run) ? 0 : 1;
+}
@@ -0,0 +1,279 @@
+// priority_wait.cpp -- time to first ring per priority class, with and without priorities
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+// usage: priority_wait [-t seconds] [-s seed]
+//
+// Replays one busy session twice over a table of its own with two HIGH, two NORMAL and two LOW
+// priority stations: once with the priorities as listed, and once with every station LOW, which
+// makes ring_age() the plain waiting time that chose the next ringer before priority classes
+// were added. Each station is called at scripted times (every 5-30 s after its last call
+// ended), and the caller hangs up 2-6 s after hearing the first ring. A call that falls due
+// while the last one is still waiting starts once it is over. The script is the same for both
+// runs.
+//
+// Prints the number of calls and the mean, p95 and longest time from a call to the first ring
+// for each class under each policy. Fails if a call goes unrung for longer than
+// max_first_ring_msec under either policy, or if the HIGH class's p95 is no better with
+// priorities than without.
+
+#include "sim.h"
+#include "station_info.h"
+#include "station_states.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <vector>
+
+const struct Station_Info stations[] = {
+  //                   buzzer     called    off_hook   timeout  code  priority          dot  space
+  { STATION_NORMAL,   8, HIGH,   A0, LOW,   2, LOW,   0,       "HA", PRIORITY_HIGH,    0,   0   },
+  { STATION_NORMAL,   9, HIGH,   A1, LOW,   3, LOW,   0,       "HB", PRIORITY_HIGH,    0,   0   },
+  { STATION_NORMAL,  10, HIGH,   A2, LOW,   4, LOW,   0,       "NA", PRIORITY_NORMAL,  0,   0   },
+  { STATION_NORMAL,  11, HIGH,   A3, LOW,   5, LOW,   0,       "NB", PRIORITY_NORMAL,  0,   0   },
+  { STATION_NORMAL,  12, HIGH,   A4, LOW,   6, LOW,   0,       "LA", PRIORITY_LOW,     0,   0   },
+  { STATION_NORMAL,  13, HIGH,   A5, LOW,   7, LOW,   0,       "LB", PRIORITY_LOW,     0,   0   },
+};
+const int num_stations = sizeof(stations) / sizeof(stations[0]);
+const char station_table_name[] = "PRIORITY_WAIT";
+const char ambience_00[] PROGMEM = "DS";
+const char * const ambience_messages[] PROGMEM = { ambience_00 };
+const int num_ambience_messages = 1;
+
+void setup()
+{
+  init_station_states();
+}
+
+void loop()
+{
+  run_station_states();
+}
+
+static const unsigned pass_usec = 500;
+static const unsigned long max_first_ring_msec = 240000;
+static const int num_classes = 3;
+static const char * const class_names[num_classes] = { "LOW", "NORMAL", "HIGH" };
+
+static unsigned long long run_micros = 3600000000ULL;
+static uint32_t seed = 1;
+
+struct Random {
+  uint32_t state;
+  Random(uint32_t seed) : state(seed ? seed : 1) { }
+  uint32_t below(uint32_t n) { state ^= state << 13; state ^= state >> 17; state ^= state << 5; return state % n; }
+};
+
+// One call in the script
+struct Call {
+  unsigned long long at;             // when the caller starts calling
+  unsigned long long hang_up_after;  // how long after the first ring the caller hangs up
+};
+
+struct Result {
+  std::vector<unsigned long long> first_ring[num_classes];
+  unsigned long long unrung_max;  // the longest a call has gone without a ring so far
+};
+
+static std::vector<Call> script[num_stations];
+static Station_Priority priorities[num_stations];
+
+static Station_Info *
+station(int ii)
+{
+  return const_cast<Station_Info *>(&stations[ii]);
+}
+
+static void
+write_script()
+{
+  Random random(seed);
+  for (int ii = 0; ii < num_stations; ii++) {
+    priorities[ii] = stations[ii].priority_;
+    for (unsigned long long at = 1000000ULL * (1 + random.below(10)); at < run_micros; ) {
+      Call call;
+      call.at = at;
+      call.hang_up_after = 1000000ULL * (2 + random.below(5));
+      script[ii].push_back(call);
+      at += call.hang_up_after + 1000000ULL * (5 + random.below(26));
+    }
+  }
+}
+
+// Runs the script, returning each call's time to first ring in the result pipe
+static int
+replay(bool with_priorities, int result_fd)
+{
+  sim_reset(seed);
+  for (int ii = 0; ii < num_stations; ii++)
+    station(ii)->priority_ = with_priorities ? priorities[ii] : PRIORITY_LOW;
+  setup();
+
+  size_t next[num_stations] = { 0 };
+  bool calling[num_stations] = { false }, rang[num_stations] = { false };
+  unsigned long long called_at[num_stations], hang_up_at[num_stations];
+  std::vector<unsigned long long> first_ring[num_classes];
+  unsigned long long unrung_max = 0;
+
+  const unsigned long long start = sim_micros;
+  while (sim_micros - start < run_micros) {
+    const unsigned long long now = sim_micros - start;
+    for (int ii = 0; ii < num_stations; ii++) {
+      Station_Info * const s = station(ii);
+      // A caller hangs up once answered; a call that falls due before then waits for that
+      if (calling[ii] && rang[ii] && (now >= hang_up_at[ii])) {
+        calling[ii] = false;
+        sim_input[s->called_pin_] = HIGH;
+      }
+      if (!calling[ii] && (next[ii] < script[ii].size()) && (now >= script[ii][next[ii]].at)) {
+        calling[ii] = true;
+        rang[ii] = false;
+        called_at[ii] = now;
+        hang_up_at[ii] = script[ii][next[ii]].hang_up_after;
+        next[ii]++;
+        sim_input[s->called_pin_] = LOW;
+      }
+    }
+
+    loop();
+    sim_micros += pass_usec;
+
+    for (int ii = 0; ii < num_stations; ii++) {
+      const Station_Info &s = stations[ii];
+      if (!calling[ii] || rang[ii])
+        continue;
+      const unsigned long long waited = sim_micros - start - called_at[ii];
+      if (sim_output(s.buzzer_pin_) == (s.buzzer_active_ == HIGH)) {
+        rang[ii] = true;
+        hang_up_at[ii] += sim_micros - start;
+        first_ring[priorities[ii]].push_back(waited);
+      }
+      if (waited > unrung_max)
+        unrung_max = waited;
+    }
+  }
+
+  // The child's results go back to the parent as a count and the times for each class
+  for (int cc = 0; cc < num_classes; cc++) {
+    const size_t count = first_ring[cc].size();
+    if ((write(result_fd, &count, sizeof(count)) != sizeof(count)) ||
+        (write(result_fd, first_ring[cc].data(), count * sizeof(unsigned long long)) != static_cast<ssize_t>(count * sizeof(unsigned long long))))
+      return 1;
+  }
+  return (write(result_fd, &unrung_max, sizeof(unrung_max)) == sizeof(unrung_max)) ? 0 : 1;
+}
+
+static bool replay_priorities;
+static int  replay_fd;
+
+static int
+replay_child()
+{
+  return replay(replay_priorities, replay_fd);
+}
+
+static bool
+read_all(int fd, void *buffer, size_t size)
+{
+  char *p = static_cast<char *>(buffer);
+  while (size > 0) {
+    const ssize_t got = read(fd, p, size);
+    if (got <= 0)
+      return false;
+    p += got;
+    size -= got;
+  }
+  return true;
+}
+
+static bool
+run_policy(bool with_priorities, Result *result)
+{
+  // An hour's results are a few KB, well within what the pipe holds before it is read
+  int fds[2];
+  if (pipe(fds) != 0) {
+    perror("pipe");
+    return false;
+  }
+  replay_priorities = with_priorities;
+  replay_fd = fds[1];
+  const bool ran = sim_run_child(replay_child);
+  close(fds[1]);
+  bool ok = ran;
+  for (int cc = 0; ok && (cc < num_classes); cc++) {
+    size_t count;
+    ok = read_all(fds[0], &count, sizeof(count));
+    if (ok) {
+      result->first_ring[cc].resize(count);
+      ok = read_all(fds[0], result->first_ring[cc].data(), count * sizeof(unsigned long long));
+    }
+    std::sort(result->first_ring[cc].begin(), result->first_ring[cc].end());
+  }
+  ok = ok && read_all(fds[0], &result->unrung_max, sizeof(result->unrung_max));
+  close(fds[0]);
+  return ok;
+}
+
+static double
+p95_msec(const std::vector<unsigned long long> &sorted)
+{
+  return sorted.empty() ? 0 : sorted[(sorted.size() * 95) / 100] / 1000.0;
+}
+
+static void
+print_policy(const char *name, const Result &result)
+{
+  for (int cc = num_classes - 1; cc >= 0; cc--) {
+    const std::vector<unsigned long long> &times = result.first_ring[cc];
+    double total = 0;
+    for (size_t ii = 0; ii < times.size(); ii++)
+      total += times[ii];
+    printf("%-13s %-6s %5zu calls  mean %7.0f msec  p95 %7.0f msec  max %7.0f msec\n",
+           name, class_names[cc], times.size(), times.empty() ? 0 : total / times.size() / 1000.0,
+           p95_msec(times), times.empty() ? 0 : times.back() / 1000.0);
+  }
+}
+
+int
+main(int argc, char **argv)
+{
+  for (int ii = 1; ii < argc; ii += 2) {
+    if ((ii + 1 < argc) && !strcmp(argv[ii], "-t")) {
+      run_micros = 1000000ULL * atof(argv[ii + 1]);
+    } else if ((ii + 1 < argc) && !strcmp(argv[ii], "-s")) {
+      seed = strtoul(argv[ii + 1], 0, 0);
+    } else {
+      fprintf(stderr, "usage: priority_wait [-t seconds] [-s seed]\n");
+      return 2;
+    }
+  }
+  write_script();
+
+  Result oldest_first, prioritised;
+  if (!run_policy(false, &oldest_first) || !run_policy(true, &prioritised))
+    return 2;
+
+  printf("table %s, %.0f s busy session, seed %u, time from call to first ring:\n",
+         station_table_name, run_micros / 1e6, seed);
+  print_policy("oldest first", oldest_first);
+  print_policy("priorities", prioritised);
+
+  const unsigned long long unrung_max = std::max(oldest_first.unrung_max, prioritised.unrung_max);
+  const bool ok = (unrung_max <= 1000ULL * max_first_ring_msec) &&
+                  (p95_msec(prioritised.first_ring[PRIORITY_HIGH]) < p95_msec(oldest_first.first_ring[PRIORITY_HIGH]));
+  printf("%s\n", ok ? "ok" : "FAILED");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,108 @@
+// profile_report.cpp -- the profile report, and what it costs the ticks it measures
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+// Runs the sketch with WANT_PROFILE at 9600 baud for ten simulated minutes of random calls and
+// answers, with WANT_MEMORY_STATS as well so that the reports have every field. The simulated
+// clock only moves between loop() passes or while a serial write waits for room, so
+// tick_max_us in the reports is exactly the time the timed passes spent blocked on the UART.
+// Fails unless every report line is complete and neither the ticks nor loop() as a whole were
+// ever held up by the port.
+
+#include "sim.h"
+#include "station_info.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+static const unsigned long long run_micros = 600000000ULL;
+static const unsigned pass_usec = 100;
+
+struct Random {
+  uint32_t state;
+  Random(uint32_t seed) : state(seed) { }
+  uint32_t below(uint32_t n) { state ^= state << 13; state ^= state >> 17; state ^= state << 5; return state % n; }
+};
+
+static int
+run()
+{
+  sim_reset(1);
+  sim_serial[0].tx_baud = 9600;
+  setup();
+  const size_t banner = sim_serial[0].tx.size();
+
+  std::vector<uint8_t> pins;
+  for (int ii = 0; ii < num_stations; ii++) {
+    if (stations[ii].station_type_ != STATION_AMBIENCE) {
+      pins.push_back(stations[ii].called_pin_);
+      pins.push_back(stations[ii].off_hook_pin_);
+    }
+  }
+
+  Random random(7);
+  const unsigned long long start = sim_micros;
+  unsigned long long next_change = start, last_pass = 0, worst = 0;
+  while (sim_micros - start < run_micros) {
+    if (sim_micros >= next_change) {
+      const uint8_t pin = pins[random.below(pins.size())];
+      sim_input[pin] = !sim_input[pin];
+      next_change = sim_micros + 200000 + random.below(2000000);
+    }
+    if (last_pass && (sim_micros - last_pass > worst))
+      worst = sim_micros - last_pass;
+    last_pass = sim_micros;
+    loop();
+    sim_micros += pass_usec;
+  }
+
+  // Every line after the banner must be a whole report
+  static const char * const keys[] = {
+    "PROFILE table=", " ticks=", " tick_avg_us=", " tick_max_us=", " edge_late_max_ms=", " flash_bytes=", " sram_free_min="
+  };
+  const std::string &tx = sim_serial[0].tx;
+  unsigned reports = 0, bad = 0;
+  unsigned long tick_max_us = 0;
+  for (size_t line = banner, end; (end = tx.find('\n', line)) != std::string::npos; line = end + 1) {
+    const std::string text = tx.substr(line, end - line);
+    size_t at = 0;
+    for (unsigned kk = 0; kk < sizeof(keys) / sizeof(keys[0]); kk++) {
+      at = text.find(keys[kk], at);
+      if (at == std::string::npos)
+        break;
+    }
+    if ((at == std::string::npos) || (text.compare(0, strlen(keys[0]), keys[0]) != 0)) {
+      printf("bad line: %s\n", text.c_str());
+      bad++;
+      continue;
+    }
+    reports++;
+    const unsigned long max_us = strtoul(text.c_str() + text.find(keys[3]) + strlen(keys[3]), 0, 10);
+    if (max_us > tick_max_us)
+      tick_max_us = max_us;
+  }
+
+  printf("table %s, 9600 baud: %u reports, worst tick_max_us %lu, worst gap between loop() passes %.1f msec\n",
+         station_table_name, reports, tick_max_us, worst / 1000.0);
+  const bool ok = (bad == 0) && (reports >= run_micros / 10000000 - 1) && (tick_max_us == 0) && (worst <= 2 * pass_usec);
+  printf("%s\n", ok ? "ok" : "FAILED");
+  return ok ? 0 : 1;
+}
+
+int
+main()
+{
+  return sim_run_child(run) ? 0 : 1;
+}
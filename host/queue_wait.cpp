@@ -0,0 +1,123 @@
+// queue_wait.cpp -- measures how long called stations wait for their first ring
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+// usage: queue_wait [dot_msec char_space_msec] ...
+//
+// Calls every phone station at once, notes how long each waits until its buzzer first sounds,
+// hangs them all up, waits 30 s, and repeats for 20 rounds. Prints the mean wait for each
+// code speed given on the command line (0 0 is the standard 100 msec dot and 3 dot space), as
+// set in every station's "dot msec" and "space msec" columns. With no arguments it runs the
+// settings compared when per-station code speed was added.
+
+#include "sim.h"
+#include "station_info.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static const int rounds = 20;
+static const unsigned pass_usec = 100;
+
+static unsigned dot_msec, char_space_msec;
+
+static Station_Info *
+station(int ii)
+{
+  return const_cast<Station_Info *>(&stations[ii]);
+}
+
+static bool
+buzzing(Station_Info *s)
+{
+  return sim_output(s->buzzer_pin_) == (s->buzzer_active_ == HIGH);
+}
+
+static void
+set_called(Station_Info *s, bool called)
+{
+  sim_input[s->called_pin_] = called ? (s->called_active_ & ~ANALOG_IN) : !(s->called_active_ & ~ANALOG_IN);
+}
+
+static int
+measure()
+{
+  sim_reset(1);
+  for (int ii = 0; ii < num_stations; ii++) {
+    station(ii)->dot_msec_ = dot_msec;
+    station(ii)->char_space_msec_ = char_space_msec;
+  }
+  setup();
+
+  double total_msec = 0;
+  int rung = 0;
+  for (int round = 0; round < rounds; round++) {
+    const unsigned long long start = sim_micros;
+    bool waiting[32];
+    int left = 0;
+    for (int ii = 0; ii < num_stations; ii++) {
+      waiting[ii] = !station(ii)->is_ambience();
+      if (waiting[ii]) {
+        set_called(station(ii), true);
+        left++;
+      }
+    }
+
+    while (left && (sim_micros - start < 600000000ULL)) {
+      loop();
+      sim_micros += pass_usec;
+      for (int ii = 0; ii < num_stations; ii++) {
+        if (waiting[ii] && buzzing(station(ii))) {
+          waiting[ii] = false;
+          left--;
+          total_msec += (sim_micros - start) / 1000.0;
+          rung++;
+        }
+      }
+    }
+
+    for (int ii = 0; ii < num_stations; ii++) {
+      if (!station(ii)->is_ambience())
+        set_called(station(ii), false);
+    }
+    sim_run_until(sim_micros + 30000000ULL, pass_usec);
+  }
+
+  printf("%3u msec dot, %4u msec char space: %d rings, mean wait to first ring %.0f msec\n",
+         dot_msec ? dot_msec : 100, char_space_msec ? char_space_msec : 3 * (dot_msec ? dot_msec : 100),
+         rung, total_msec / rung);
+  return 0;
+}
+
+int
+main(int argc, char **argv)
+{
+  static const char * const defaults[] = { "0", "0", "70", "0", "60", "300", "50", "250" };
+  if (argc == 1) {
+    argc = 1 + sizeof(defaults) / sizeof(defaults[0]);
+    argv = const_cast<char **>(defaults) - 1;
+  }
+  if ((argc - 1) % 2 != 0) {
+    fprintf(stderr, "usage: queue_wait [dot_msec char_space_msec] ...\n");
+    return 2;
+  }
+
+  printf("table %s, every phone station called at once, %d rounds\n", station_table_name, rounds);
+  for (int ii = 1; ii + 1 < argc; ii += 2) {
+    dot_msec = atoi(argv[ii]);
+    char_space_msec = atoi(argv[ii + 1]);
+    if (!sim_run_child(measure))
+      return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,524 @@
+// ring_bus_sim.cpp -- several boards passing the ring token over a simulated bus
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+// usage: ring_bus_sim [-v] [-n nodes] [-t seconds] [-s seed] [--loss P] [--ack-loss P] [--kill node@sec]
+//
+// Runs one copy of the sketch (built with WANT_RING_BUS) per board, each in its own process
+// connected to this one by a pair of pipes, and steps them all in lock step. This process is
+// the bus: every byte a board writes to Serial1 is delivered to all the boards, itself included
+// as on a half-duplex RS-485 bus, one byte time (38400 baud) after the last. Bytes from two
+// boards that overlap on the wire collide and arrive corrupted. Faults can be added:
+//
+//   --loss P       each board misses each frame with probability P
+//   --ack-loss P   every ACK frame is lost, for all boards, with probability P
+//   --kill N@S     board N loses power S seconds into the run
+//
+// -v lists every frame as it goes on the wire, with the boards that miss it, and every change
+// of the buzzers.
+//
+// Each board has three phone stations whose callers call and hang up at random. The run
+// fails (exit status 1) if two boards ever sound a buzzer at the same time, or if a called
+// station waits longer than max_wait_msec for its first ring. It also reports the hand-off
+// latency, from the first TOKEN going on the wire to the end of the ACK or HOLD with the same
+// sequence number from the node it names (p95 and max, with the TOKENs never answered), and
+// the bus utilisation: the time at least one board is driving the bus over the whole run.
+
+#include "sim.h"
+#include "station_info.h"
+#include "ring_bus.h"
+#include "station_states.h"
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+// The board side: a minimal sketch with three stations, built around the real ring bus and
+// state machine code
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+static uint8_t node_id_from_environment()
+{
+  const char *id = getenv("RING_BUS_SIM_NODE");
+  return id ? atoi(id) : 0;
+}
+
+static uint8_t num_nodes_from_environment()
+{
+  const char *num = getenv("RING_BUS_SIM_NODES");
+  return num ? atoi(num) : 1;
+}
+
+const uint8_t ring_bus_node_id = node_id_from_environment();
+const uint8_t ring_bus_num_nodes = num_nodes_from_environment();
+const int8_t  ring_bus_tx_enable_pin = -1;
+
+static const int stations_per_node = 3;
+const struct Station_Info stations[stations_per_node] = {
+  { STATION_NORMAL,  8, HIGH,  A0, LOW,  2, LOW,  0, "AA", PRIORITY_NORMAL, 0, 0 },
+  { STATION_NORMAL,  9, HIGH,  A1, LOW,  3, LOW,  0, "BB", PRIORITY_NORMAL, 0, 0 },
+  { STATION_NORMAL, 10, HIGH,  A2, LOW,  4, LOW,  0, "CC", PRIORITY_NORMAL, 0, 0 },
+};
+const int num_stations = stations_per_node;
+const char station_table_name[] = "RING_BUS_SIM";
+const char ambience_00[] PROGMEM = "DS";
+const char * const ambience_messages[] PROGMEM = { ambience_00 };
+const int num_ambience_messages = 1;
+
+void setup()
+{
+  init_ring_bus();
+  init_station_states();
+}
+
+void loop()
+{
+  run_ring_bus();
+  run_station_states();
+}
+
+static const int max_step_bytes = 64;
+
+struct Step {
+  unsigned long long micros;
+  uint8_t            called;       // bit per station: its caller is calling
+  uint8_t            num_rx;
+  uint8_t            rx[max_step_bytes];
+};
+
+struct Reply {
+  uint8_t buzzing;                 // bit per station
+  uint8_t num_tx;
+  uint8_t tx[max_step_bytes];
+};
+
+static bool
+read_all(int fd, void *buffer, size_t size)
+{
+  char *p = static_cast<char *>(buffer);
+  while (size > 0) {
+    const ssize_t got = read(fd, p, size);
+    if (got <= 0)
+      return false;
+    p += got;
+    size -= got;
+  }
+  return true;
+}
+
+static bool
+write_all(int fd, const void *buffer, size_t size)
+{
+  const char *p = static_cast<const char *>(buffer);
+  while (size > 0) {
+    const ssize_t put = write(fd, p, size);
+    if (put <= 0)
+      return false;
+    p += put;
+    size -= put;
+  }
+  return true;
+}
+
+// One board: wait for each step from the bus, run loop() once, and report back
+static int
+run_node(int in_fd, int out_fd)
+{
+  sim_reset(1 + ring_bus_node_id);
+  bool started = false;
+  Step step;
+  while (read_all(in_fd, &step, sizeof(step))) {
+    sim_micros = step.micros;
+    for (int ii = 0; ii < stations_per_node; ii++)
+      sim_input[stations[ii].called_pin_] = (step.called & (1 << ii)) ? LOW : HIGH;
+    sim_serial_send(1, std::string(step.rx, step.rx + step.num_rx));
+    if (!started) {
+      setup();
+      started = true;
+    } else {
+      loop();
+    }
+
+    Reply reply;
+    reply.buzzing = 0;
+    for (int ii = 0; ii < stations_per_node; ii++)
+      reply.buzzing |= sim_output(stations[ii].buzzer_pin_) ? (1 << ii) : 0;
+    std::string &tx = sim_serial[1].tx;
+    reply.num_tx = (tx.size() < max_step_bytes) ? tx.size() : max_step_bytes;
+    memcpy(reply.tx, tx.data(), reply.num_tx);
+    tx.erase(0, reply.num_tx);
+    if (!write_all(out_fd, &reply, sizeof(reply)))
+      break;
+  }
+  return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+// The bus side
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+static const unsigned step_usec = 500;
+static const unsigned byte_usec = 10000000UL / 38400;
+static const unsigned long max_wait_msec = 60000;
+static const uint8_t frame_sync = 0xA5;
+static const uint8_t frame_length = 6;
+static const uint8_t frame_token = 1;
+static const uint8_t frame_ack = 2;
+static const uint8_t frame_hold = 3;
+
+struct Random {
+  uint32_t state;
+  Random(uint32_t seed) : state(seed ? seed : 1) { }
+  uint32_t next() { state ^= state << 13; state ^= state >> 17; state ^= state << 5; return state; }
+  bool chance(double p) { return (next() % 1000000) < p * 1000000; }
+  uint32_t below(uint32_t n) { return next() % n; }
+};
+
+// A byte on the wire
+struct Wire_Byte {
+  unsigned long long start, end;
+  uint8_t            value;
+  int                src;
+  int                frame;        // index into frames, for dropping whole frames
+};
+
+struct Node {
+  pid_t              pid;
+  int                to_node, from_node;
+  bool               alive;
+  unsigned long long tx_busy_until;
+  int                open_frame;   // the frame this board is in the middle of sending, or -1
+  Step               step;
+  // The callers
+  uint8_t            called;
+  unsigned long long next_change[stations_per_node];
+  unsigned long long called_since[stations_per_node];
+  bool               rang[stations_per_node];
+  // Results
+  uint8_t            buzzing;
+  unsigned long long quiet_since;
+  unsigned           rings;
+};
+
+struct Frame {
+  uint8_t            type;
+  bool               lost_for_all;
+  std::vector<bool>  lost_for;
+  std::vector<uint8_t> bytes;
+};
+
+// A TOKEN on the wire that the node it names has not yet answered with an ACK or HOLD
+struct Hand_Off {
+  bool               open;
+  uint8_t            seq;
+  unsigned long long sent;         // start of the first TOKEN with this number (repeats keep it)
+};
+
+static void
+start_node(Node *node, int id, int num_nodes, const char *self)
+{
+  int to[2], from[2];
+  if ((pipe(to) != 0) || (pipe(from) != 0)) {
+    perror("pipe");
+    exit(2);
+  }
+  node->pid = fork();
+  if (node->pid == 0) {
+    // The board is this same program started afresh, so its globals (and the node id) are its own
+    char fd_in[16], fd_out[16], id_text[8], nodes_text[8];
+    snprintf(fd_in, sizeof(fd_in), "%d", to[0]);
+    snprintf(fd_out, sizeof(fd_out), "%d", from[1]);
+    snprintf(id_text, sizeof(id_text), "%d", id);
+    snprintf(nodes_text, sizeof(nodes_text), "%d", num_nodes);
+    setenv("RING_BUS_SIM_NODE", id_text, 1);
+    setenv("RING_BUS_SIM_NODES", nodes_text, 1);
+    close(to[1]);
+    close(from[0]);
+    execl(self, self, "--node", fd_in, fd_out, (char *) 0);
+    perror("exec");
+    _exit(2);
+  }
+  close(to[0]);
+  close(from[1]);
+  node->to_node = to[1];
+  node->from_node = from[0];
+}
+
+int
+main(int argc, char **argv)
+{
+  if ((argc == 4) && !strcmp(argv[1], "--node"))
+    return run_node(atoi(argv[2]), atoi(argv[3]));
+
+  int num_nodes = 3;
+  double seconds = 300;
+  uint32_t seed = 1;
+  double loss = 0, ack_loss = 0;
+  int kill_node = -1;
+  double kill_sec = 0;
+  bool verbose = false;
+
+  int first = 1;
+  if ((argc > 1) && !strcmp(argv[1], "-v")) {
+    verbose = true;
+    first = 2;
+  }
+  for (int ii = first; ii + 1 < argc; ii += 2) {
+    const char *arg = argv[ii], *value = argv[ii + 1];
+    if (!strcmp(arg, "-n"))              num_nodes = atoi(value);
+    else if (!strcmp(arg, "-t"))         seconds = atof(value);
+    else if (!strcmp(arg, "-s"))         seed = strtoul(value, 0, 0);
+    else if (!strcmp(arg, "--loss"))     loss = atof(value);
+    else if (!strcmp(arg, "--ack-loss")) ack_loss = atof(value);
+    else if (!strcmp(arg, "--kill"))     sscanf(value, "%d@%lf", &kill_node, &kill_sec);
+    else {
+      fprintf(stderr, "usage: ring_bus_sim [-v] [-n nodes] [-t seconds] [-s seed] [--loss P] [--ack-loss P] [--kill node@sec]\n");
+      return 2;
+    }
+  }
+  if (((argc - first) % 2) != 0 || (num_nodes < 1) || (num_nodes > 8)) {
+    fprintf(stderr, "usage: ring_bus_sim [-v] [-n nodes] [-t seconds] [-s seed] [--loss P] [--ack-loss P] [--kill node@sec]\n");
+    return 2;
+  }
+  signal(SIGPIPE, SIG_IGN);
+
+  Random random(seed);
+  std::vector<Node> nodes(num_nodes);
+  for (int nn = 0; nn < num_nodes; nn++) {
+    Node &node = nodes[nn];
+    start_node(&node, nn, num_nodes, argv[0]);
+    node.alive = true;
+    node.tx_busy_until = 0;
+    node.open_frame = -1;
+    node.called = 0;
+    node.buzzing = 0;
+    node.quiet_since = 0;
+    node.rings = 0;
+    for (int ss = 0; ss < stations_per_node; ss++) {
+      node.next_change[ss] = 1000000ULL * (1 + random.below(10));
+      node.rang[ss] = false;
+    }
+  }
+
+  std::vector<Wire_Byte> wire;      // bytes sent and not yet delivered to everyone
+  std::vector<Frame> frames;
+  std::vector<Hand_Off> hand_offs(num_nodes);
+  std::vector<unsigned long long> hand_off_usec;
+  std::vector<std::pair<unsigned long long, unsigned long long> > busy;  // every byte's time on the wire
+  unsigned unanswered = 0;
+  unsigned long long overlap_usec = 0, worst_wait = 0;
+  unsigned overlaps = 0, collisions = 0, frames_sent = 0;
+  bool overlapping = false;
+  const unsigned long long end = 1000000ULL * seconds;
+
+  for (unsigned long long now = 0; now < end; now += step_usec) {
+    for (int nn = 0; nn < num_nodes; nn++) {
+      Node &node = nodes[nn];
+      node.step.micros = now;
+      node.step.num_rx = 0;
+
+      if (node.alive && (nn == kill_node) && (now >= 1000000ULL * kill_sec)) {
+        kill(node.pid, SIGKILL);
+        node.alive = false;
+        node.buzzing = 0;
+        printf("%8.3f s  node %d loses power\n", now / 1e6, nn);
+      }
+
+      // The callers call for 5-20 s and hang up for 0-10 s, at random
+      for (int ss = 0; ss < stations_per_node; ss++) {
+        if (now < node.next_change[ss])
+          continue;
+        node.called ^= (1 << ss);
+        if (node.called & (1 << ss)) {
+          node.called_since[ss] = now;
+          node.rang[ss] = false;
+          node.next_change[ss] = now + 1000000ULL * (5 + random.below(16));
+        } else {
+          node.next_change[ss] = now + 1000ULL * random.below(10000);
+        }
+      }
+      node.step.called = node.called;
+    }
+
+    // Deliver the bytes that have finished arriving
+    size_t kept = 0;
+    for (size_t bb = 0; bb < wire.size(); bb++) {
+      const Wire_Byte &byte = wire[bb];
+      if (byte.end > now) {
+        wire[kept++] = byte;
+        continue;
+      }
+      bool collided = false;
+      for (size_t oo = 0; oo < wire.size(); oo++) {
+        if ((wire[oo].src != byte.src) && (wire[oo].start < byte.end) && (byte.start < wire[oo].end))
+          collided = true;
+      }
+      if (collided)
+        collisions++;
+      const Frame &frame = frames[byte.frame];
+      for (int nn = 0; nn < num_nodes; nn++) {
+        Node &node = nodes[nn];
+        if (frame.lost_for_all || frame.lost_for[nn] || (node.step.num_rx == max_step_bytes))
+          continue;
+        node.step.rx[node.step.num_rx++] = collided ? (byte.value ^ 0x5a) : byte.value;
+      }
+    }
+    wire.resize(kept);
+
+    // Step every board, and put what they send on the wire
+    for (int nn = 0; nn < num_nodes; nn++) {
+      Node &node = nodes[nn];
+      if (!node.alive)
+        continue;
+      Reply reply;
+      if (!write_all(node.to_node, &node.step, sizeof(node.step)) ||
+          !read_all(node.from_node, &reply, sizeof(reply))) {
+        fprintf(stderr, "node %d died\n", nn);
+        return 2;
+      }
+
+      for (int ii = 0; ii < reply.num_tx; ii++) {
+        // A sync byte inside a frame is just data
+        const bool in_frame = (node.open_frame >= 0) && (frames[node.open_frame].bytes.size() < frame_length);
+        if ((reply.tx[ii] == frame_sync) && !in_frame) {
+          Frame frame;
+          frame.type = (ii + 1 < reply.num_tx) ? reply.tx[ii + 1] : 0;
+          frame.lost_for_all = (frame.type == frame_ack) && random.chance(ack_loss);
+          for (int rr = 0; rr < num_nodes; rr++)
+            frame.lost_for.push_back(random.chance(loss));
+          node.open_frame = frames.size();
+          frames.push_back(frame);
+          frames_sent++;
+          if (verbose) {
+            printf("%8.3f s  node %d:", now / 1e6, nn);
+            for (int jj = ii; (jj < reply.num_tx) && ((jj == ii) || (reply.tx[jj] != frame_sync)); jj++)
+              printf(" %02x", reply.tx[jj]);
+            for (int rr = 0; rr < num_nodes; rr++) {
+              if (frame.lost_for_all || frame.lost_for[rr])
+                printf(" (lost by %d)", rr);
+            }
+            printf("\n");
+          }
+        }
+        if (node.open_frame < 0)
+          continue;
+        Wire_Byte byte;
+        byte.start = (node.tx_busy_until > now) ? node.tx_busy_until : now;
+        byte.end = byte.start + byte_usec;
+        byte.value = reply.tx[ii];
+        byte.src = nn;
+        byte.frame = node.open_frame;
+        node.tx_busy_until = byte.end;
+        wire.push_back(byte);
+        busy.push_back(std::make_pair(byte.start, byte.end));
+
+        // Time each hand-off from the first TOKEN to the end of the ACK or HOLD that answers it
+        Frame &frame = frames[node.open_frame];
+        frame.bytes.push_back(byte.value);
+        if (frame.bytes.size() != frame_length)
+          continue;
+        const uint8_t type = frame.bytes[1], src = frame.bytes[2], dst = frame.bytes[3], seq = frame.bytes[4];
+        if ((type == frame_token) && (dst < num_nodes)) {
+          Hand_Off &hand_off = hand_offs[dst];
+          if (hand_off.open && (hand_off.seq == seq))
+            continue;
+          if (hand_off.open)
+            unanswered++;
+          hand_off.open = true;
+          hand_off.seq = seq;
+          hand_off.sent = byte.end - frame_length * byte_usec;
+        } else if (((type == frame_ack) || (type == frame_hold)) && (src < num_nodes)) {
+          Hand_Off &hand_off = hand_offs[src];
+          if (hand_off.open && (hand_off.seq == seq)) {
+            hand_off_usec.push_back(byte.end - hand_off.sent);
+            hand_off.open = false;
+          }
+        }
+      }
+
+      if (verbose && (reply.buzzing != node.buzzing))
+        printf("%8.3f s  node %d buzzers %x\n", now / 1e6, nn, reply.buzzing);
+      if (reply.buzzing && !node.buzzing && (now - node.quiet_since > 1000000ULL))
+        node.rings++;
+      if (!reply.buzzing && node.buzzing)
+        node.quiet_since = now;
+      node.buzzing = reply.buzzing;
+
+      for (int ss = 0; ss < stations_per_node; ss++) {
+        if (!(node.called & (1 << ss)) || node.rang[ss])
+          continue;
+        if (reply.buzzing & (1 << ss)) {
+          node.rang[ss] = true;
+          if (now - node.called_since[ss] > worst_wait)
+            worst_wait = now - node.called_since[ss];
+        } else if ((now - node.called_since[ss] > 1000ULL * max_wait_msec) && (now - node.called_since[ss] > worst_wait)) {
+          worst_wait = now - node.called_since[ss];
+        }
+      }
+    }
+
+    int sounding = 0;
+    for (int nn = 0; nn < num_nodes; nn++)
+      sounding += (nodes[nn].buzzing != 0);
+    if (sounding > 1) {
+      overlap_usec += step_usec;
+      if (!overlapping) {
+        overlaps++;
+        printf("%8.3f s  two boards buzzing at once\n", now / 1e6);
+      }
+    }
+    overlapping = (sounding > 1);
+  }
+
+  for (int nn = 0; nn < num_nodes; nn++) {
+    if (nodes[nn].alive)
+      kill(nodes[nn].pid, SIGKILL);
+    waitpid(nodes[nn].pid, 0, 0);
+  }
+
+  for (int nn = 0; nn < num_nodes; nn++)
+    unanswered += hand_offs[nn].open;
+  std::sort(hand_off_usec.begin(), hand_off_usec.end());
+  const size_t num_hand_offs = hand_off_usec.size();
+  const double hand_off_p95_msec = num_hand_offs ? hand_off_usec[(num_hand_offs * 95) / 100] / 1e3 : 0;
+  const double hand_off_max_msec = num_hand_offs ? hand_off_usec.back() / 1e3 : 0;
+
+  // Bus utilisation: the time at least one board is driving the bus, over the whole run
+  std::sort(busy.begin(), busy.end());
+  unsigned long long busy_usec = 0, covered = 0;
+  for (size_t bb = 0; bb < busy.size(); bb++) {
+    const unsigned long long from = (busy[bb].first > covered) ? busy[bb].first : covered;
+    if (busy[bb].second > from)
+      busy_usec += busy[bb].second - from;
+    if (busy[bb].second > covered)
+      covered = busy[bb].second;
+  }
+
+  printf("%d nodes, %.0f s, loss %.3f, ack loss %.3f: %u frames, %u bytes collided, rings",
+         num_nodes, seconds, loss, ack_loss, frames_sent, collisions);
+  for (int nn = 0; nn < num_nodes; nn++)
+    printf(" %u", nodes[nn].rings);
+  printf(", longest wait %.1f s, %u overlaps (%.1f s)\n", worst_wait / 1e6, overlaps, overlap_usec / 1e6);
+  printf("%zu hand-offs: p95 %.1f ms, max %.1f ms, %u unanswered; bus busy %.2f%%\n",
+         num_hand_offs, hand_off_p95_msec, hand_off_max_msec, unanswered, 100.0 * busy_usec / end);
+
+  const bool ok = (overlaps == 0) && (worst_wait <= 1000ULL * max_wait_msec);
+  printf("%s\n", ok ? "ok" : "FAILED");
+  return ok ? 0 : 1;
+}
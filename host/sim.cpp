@@ -0,0 +1,344 @@
+// sim.cpp -- the simulated board behind the host Arduino.h
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+#include "sim.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+unsigned long long sim_micros = 0;
+uint8_t            sim_input[NUM_DIGITAL_PINS];
+uint8_t            sim_mode[NUM_DIGITAL_PINS];
+Sim_Serial         sim_serial[2];
+volatile uint8_t   sim_port[PD + 1];
+
+volatile uint8_t   SREG;
+volatile uint8_t   TCCR1A, TCCR1B, TIMSK1;
+volatile uint16_t  OCR1A;
+volatile uint8_t   TCCR2A, TCCR2B, TIMSK2, OCR2B;
+
+uint8_t            sim_sram[sim_sram_bytes];
+uintptr_t          sim_stack_pointer;
+extern uint8_t     __heap_start __attribute__((alias("sim_sram")));
+char              *__brkval;
+struct __freelist *__flp;
+
+// memory_stats.cpp's, when the sketch is built with WANT_MEMORY_STATS
+void paint_stack() __attribute__((weak));
+
+HardwareSerial Serial(0);
+HardwareSerial Serial1(1);
+
+// random() is a xorshift generator, so that runs don't depend on the host's C library
+static uint32_t random_state = 1;
+
+void
+sim_reset(unsigned long seed)
+{
+  sim_micros = 0;
+  memset(sim_input, HIGH, sizeof(sim_input));
+  memset(sim_mode, INPUT, sizeof(sim_mode));
+  memset(const_cast<uint8_t *>(sim_port), 0, sizeof(sim_port));
+  for (int ii = 0; ii < 2; ii++)
+    sim_serial[ii] = Sim_Serial();
+  randomSeed(seed);
+  __brkval = 0;
+  __flp = 0;
+  sim_stack_pointer = RAMEND;
+  memset(sim_sram, 0, sizeof(sim_sram));
+  if (paint_stack)
+    paint_stack();
+}
+
+bool
+sim_run_child(int (*scenario)())
+{
+  fflush(stdout);
+  const pid_t pid = fork();
+  if (pid == 0) {
+    const int status = (*scenario)();
+    fflush(stdout);
+    _exit(status);
+  }
+  int status;
+  waitpid(pid, &status, 0);
+  return WIFEXITED(status) && (WEXITSTATUS(status) == 0);
+}
+
+static unsigned long long
+rx_byte_usec(const Sim_Serial &serial)
+{
+  return serial.rx_baud ? 10000000ULL / serial.rx_baud : 0;
+}
+
+// Moves whatever has reached the board by now from the wire into the receive buffer. Nothing
+// else changes rx, so doing this whenever the sketch touches the port gives the same buffer, and
+// drops the same bytes, as a UART interrupt taking each byte as it comes.
+static void
+rx_arrive(Sim_Serial &serial)
+{
+  while (!serial.rx_wire.empty() && (serial.rx_next_micros <= sim_micros)) {
+    if (serial.rx_stopped && (serial.rx_lag_left == 0))
+      break;
+    if (serial.rx_stopped)
+      serial.rx_lag_left--;
+    const uint8_t c = serial.rx_wire.front();
+    serial.rx_wire.pop_front();
+    if (serial.rx.size() < sim_serial_rx_buffer) {
+      serial.rx.push_back(c);
+      serial.rx_received++;
+    } else {
+      serial.rx_dropped++;
+    }
+    serial.rx_last_micros = serial.rx_next_micros;
+    serial.rx_next_micros += rx_byte_usec(serial);
+  }
+}
+
+// The far end starts (or starts again) sending one byte time from now
+static void
+rx_start(Sim_Serial &serial)
+{
+  if (serial.rx_next_micros < sim_micros)
+    serial.rx_next_micros = sim_micros + rx_byte_usec(serial);
+}
+
+void
+sim_serial_send(int port, const std::string &bytes)
+{
+  Sim_Serial &serial = sim_serial[port];
+  rx_arrive(serial);
+  if (serial.rx_wire.empty())
+    rx_start(serial);
+  serial.rx_wire.insert(serial.rx_wire.end(), bytes.begin(), bytes.end());
+  rx_arrive(serial);
+}
+
+void
+sim_stream_tx()
+{
+  for (int ii = 0; ii < 2; ii++) {
+    Sim_Serial &port = sim_serial[ii];
+    if (!port.tx_stream || port.tx.empty())
+      continue;
+    if (port.tx.size() > port.tx_stream_max)
+      port.tx_stream_max = port.tx.size();
+    fwrite(port.tx.data(), 1, port.tx.size(), port.tx_stream);
+    port.tx.clear();
+  }
+}
+
+void
+sim_run_until(unsigned long long until_micros, unsigned pass_usec, void (*watch)())
+{
+  while (sim_micros < until_micros) {
+    for (int ii = 0; ii < 2; ii++)
+      rx_arrive(sim_serial[ii]);
+    loop();
+    if (watch)
+      (*watch)();
+    sim_stream_tx();
+    sim_micros += pass_usec;
+  }
+}
+
+bool
+sim_output(uint8_t pin)
+{
+  const uint8_t port = digitalPinToPort(pin);
+  return (port != NOT_A_PORT) && ((sim_port[port] & digitalPinToBitMask(pin)) != 0);
+}
+
+void
+pinMode(uint8_t pin, uint8_t mode)
+{
+  if (pin < NUM_DIGITAL_PINS)
+    sim_mode[pin] = mode;
+}
+
+void
+digitalWrite(uint8_t pin, uint8_t level)
+{
+  const uint8_t port = digitalPinToPort(pin);
+  if (port == NOT_A_PORT)
+    return;
+  if (level)
+    sim_port[port] |= digitalPinToBitMask(pin);
+  else
+    sim_port[port] &= ~digitalPinToBitMask(pin);
+}
+
+int
+digitalRead(uint8_t pin)
+{
+  if (pin >= NUM_DIGITAL_PINS)
+    return LOW;
+  return (sim_mode[pin] == OUTPUT) ? sim_output(pin) : sim_input[pin];
+}
+
+int
+analogRead(uint8_t pin)
+{
+  return digitalRead(pin) ? 1023 : 0;
+}
+
+unsigned long millis() { return sim_micros / 1000; }
+unsigned long micros() { return sim_micros; }
+void delay(unsigned long msec) { sim_micros += 1000ULL * msec; }
+
+void
+randomSeed(unsigned long seed)
+{
+  random_state = seed ? seed : 1;
+}
+
+long
+random(long howbig)
+{
+  if (howbig <= 0)
+    return 0;
+  random_state ^= random_state << 13;
+  random_state ^= random_state >> 17;
+  random_state ^= random_state << 5;
+  return random_state % howbig;
+}
+
+long
+random(long howsmall, long howbig)
+{
+  return (howsmall >= howbig) ? howsmall : howsmall + random(howbig - howsmall);
+}
+
+size_t
+Print::write(const uint8_t *buffer, size_t size)
+{
+  for (size_t ii = 0; ii < size; ii++)
+    write(buffer[ii]);
+  return size;
+}
+
+size_t Print::write(const char *str) { return print(str); }
+
+size_t
+Print::print(const char *str)
+{
+  size_t n = 0;
+  while (*str)
+    n += write(static_cast<uint8_t>(*str++));
+  return n;
+}
+
+size_t Print::print(const __FlashStringHelper *str) { return print(reinterpret_cast<const char *>(str)); }
+size_t Print::print(char c) { return write(static_cast<uint8_t>(c)); }
+size_t Print::print(unsigned char n, int base) { return print(static_cast<unsigned long>(n), base); }
+size_t Print::print(int n, int base) { return print(static_cast<long>(n), base); }
+size_t Print::print(unsigned n, int base) { return print(static_cast<unsigned long>(n), base); }
+
+size_t
+Print::print(long n, int base)
+{
+  if ((n < 0) && (base == DEC))
+    return print('-') + print(static_cast<unsigned long>(-n), base);
+  return print(static_cast<unsigned long>(n), base);
+}
+
+size_t
+Print::print(unsigned long n, int base)
+{
+  char buffer[24];
+  snprintf(buffer, sizeof(buffer), (base == HEX) ? "%lX" : "%lu", n);
+  return print(buffer);
+}
+
+size_t Print::println() { return print("\r\n"); }
+
+void HardwareSerial::begin(unsigned long baud) { }
+
+int
+HardwareSerial::available()
+{
+  rx_arrive(sim_serial[port_]);
+  return sim_serial[port_].rx.size();
+}
+
+int
+HardwareSerial::peek()
+{
+  rx_arrive(sim_serial[port_]);
+  return sim_serial[port_].rx.empty() ? -1 : sim_serial[port_].rx.front();
+}
+
+int
+HardwareSerial::read()
+{
+  Sim_Serial &serial = sim_serial[port_];
+  rx_arrive(serial);
+  if (serial.rx.empty())
+    return -1;
+  const uint8_t c = serial.rx.front();
+  serial.rx.pop_front();
+  return c;
+}
+
+// Bytes still waiting in the transmit buffer
+static int
+tx_pending(const Sim_Serial &serial)
+{
+  if ((serial.tx_baud == 0) || (serial.tx_idle_micros <= sim_micros))
+    return 0;
+  const unsigned long long byte_usec = 10000000ULL / serial.tx_baud;
+  return (serial.tx_idle_micros - sim_micros + byte_usec - 1) / byte_usec;
+}
+
+int
+HardwareSerial::availableForWrite()
+{
+  const Sim_Serial &serial = sim_serial[port_];
+  return sim_serial_tx_buffer - 1 - (serial.tx_room_lies ? 0 : tx_pending(serial));
+}
+
+void
+HardwareSerial::flush()
+{
+  Sim_Serial &serial = sim_serial[port_];
+  if (serial.tx_idle_micros > sim_micros)
+    sim_micros = serial.tx_idle_micros;
+}
+
+size_t
+HardwareSerial::write(uint8_t c)
+{
+  Sim_Serial &serial = sim_serial[port_];
+  if (serial.tx_baud != 0) {
+    const unsigned long long byte_usec = 10000000ULL / serial.tx_baud;
+    while (tx_pending(serial) >= sim_serial_tx_buffer - 1)
+      sim_micros += byte_usec / 4 + 1;
+    if (serial.tx_idle_micros < sim_micros)
+      serial.tx_idle_micros = sim_micros;
+    serial.tx_idle_micros += byte_usec;
+  }
+  serial.tx += static_cast<char>(c);
+
+  rx_arrive(serial);
+  if (serial.rx_xon_xoff && (c == 0x13) && !serial.rx_stopped) {
+    serial.rx_stopped = true;
+    serial.rx_lag_left = serial.rx_xoff_lag;
+  } else if (serial.rx_xon_xoff && (c == 0x11) && serial.rx_stopped) {
+    serial.rx_stopped = false;
+    rx_start(serial);
+  }
+  return 1;
+}
@@ -0,0 +1,106 @@
+// sim.h -- the simulated board behind the host Arduino.h
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+#ifndef INCLUDED_host_sim
+#define INCLUDED_host_sim
+
+#include "Arduino.h"
+#include <stdio.h>
+#include <deque>
+#include <string>
+
+// The simulated clock. Nothing advances it but the simulator (and a serial write that has to
+// wait for room, see below), so a run is exactly repeatable.
+extern unsigned long long sim_micros;
+
+// The level each pin presents to digitalRead() / analogRead() while it is an input. Pins idle
+// HIGH, as if pulled up.
+extern uint8_t sim_input[NUM_DIGITAL_PINS];
+extern uint8_t sim_mode[NUM_DIGITAL_PINS];
+
+// The level the sketch is driving on a pin, read back from the port output registers, so it
+// sees writes made through buzzer_output.h as well as through digitalWrite()
+bool sim_output(uint8_t pin);
+
+// Serial ports: sim_serial[0] is Serial and sim_serial[1] is Serial1. The sketch reads rx and
+// appends to tx.
+//
+// A program sends to the board with sim_serial_send(), which puts the bytes on the wire to
+// arrive in rx one byte time apart at rx_baud (or all at once with rx_baud 0). rx is the
+// HardwareSerial receive buffer, so it holds at most sim_serial_rx_buffer bytes, and a byte
+// arriving while it is full is dropped and counted in rx_dropped. With rx_xon_xoff set, the far
+// end obeys the flow control the sketch writes to tx: after an XOFF it sends no more than
+// rx_xoff_lag further bytes (those already in its own UART) until an XON.
+//
+// With tx_baud set, writes go through a 64 byte transmit buffer that drains at
+// that rate: availableForWrite() reports the room left, and a write to a full buffer waits,
+// moving the clock on, just as the real HardwareSerial blocks loop().
+//
+// With tx_stream set, sim_stream_tx() (which sim_run_until() calls after every pass) writes tx
+// out to it and empties it, so a long run doesn't have to hold everything the sketch has sent;
+// tx_stream_max is the most that was waiting at once.
+struct Sim_Serial {
+  std::deque<uint8_t> rx;
+  std::deque<uint8_t> rx_wire;          // sent, yet to arrive
+  unsigned long       rx_baud;
+  unsigned long long  rx_next_micros;   // when the next byte on the wire arrives
+  bool                rx_xon_xoff;
+  unsigned            rx_xoff_lag;
+  bool                rx_stopped;       // the sketch has sent XOFF
+  unsigned            rx_lag_left;      // bytes still to come after the XOFF
+  unsigned long       rx_received;
+  unsigned long       rx_dropped;
+  unsigned long long  rx_last_micros;   // when the last byte arrived
+  std::string         tx;
+  unsigned long       tx_baud;
+  unsigned long long  tx_idle_micros;   // when the last byte written will have gone out
+  bool                tx_room_lies;     // availableForWrite() always reports an empty buffer
+  FILE               *tx_stream;
+  size_t              tx_stream_max;
+};
+static const int sim_serial_rx_buffer = 64;
+static const int sim_serial_tx_buffer = 64;
+extern Sim_Serial sim_serial[2];
+void sim_serial_send(int port, const std::string &bytes);
+void sim_stream_tx();
+
+// The heap and the stack: sim_sram stands in for the SRAM from __heap_start (its first byte) up
+// to RAMEND, with __brkval, __flp and SP alongside, for memory_stats.cpp to measure. sim_reset()
+// paints it as the start-up code does on a board, with an empty heap and stack. Nothing in the
+// sketch uses it, so a program builds the heap (setting __brkval and linking free blocks on
+// __flp) and grows the stack (writing below RAMEND and moving SP down) for itself.
+struct __freelist {
+  size_t sz;
+  struct __freelist *nx;
+};
+extern uint8_t __heap_start;
+extern char *__brkval;
+extern struct __freelist *__flp;
+
+// Put the board back to its power-on state, with random() seeded from seed. This doesn't reset
+// the sketch's own globals, so each run of setup() needs a fresh process: sim_run_child() runs
+// scenario() in a child process and returns true if it exited with status 0.
+void sim_reset(unsigned long seed);
+bool sim_run_child(int (*scenario)());
+
+// Runs loop() until the clock reaches until_micros, pass_usec apart, calling watch() (if given)
+// after every pass, then streaming out tx
+void sim_run_until(unsigned long long until_micros, unsigned pass_usec, void (*watch)() = 0);
+
+// The sketch itself
+void setup();
+void loop();
+
+#endif
@@ -0,0 +1,211 @@
+// sounder_sim.cpp -- sounder click timing against the Timer2 interrupt
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+// Builds the sketch with WANT_SOUNDER around a small table of its own, calls both stations for
+// 20 simulated seconds, and runs the Timer2 overflow handler every 510 clocks (31.875 usec)
+// between loop() passes, recording OCR2B after each one. Every buzzer edge must start the
+// matching click, and each click must come out exactly as an independent ADPCM decode of it
+// says, one level per four PWM periods, until it ends in silence or the next click cuts it off.
+//
+// The run is repeated with loop() passes 0.2 msec, 2 msec (the tasks' whole window) and 6 msec
+// apart; the first two must be exact, the last shows what happens when loop() falls behind the
+// 4 msec buffer. It also counts the handler entries and the samples decoded, the work the
+// sounder adds while a click plays. Finally the table is run with a hook switch on pin 3, where
+// the sounder must stay off.
+
+#include "sim.h"
+#include "station_info.h"
+#include "station_states.h"
+#include "sounder.h"
+#include "sounder_samples.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <vector>
+
+static uint8_t second_off_hook_pin()
+{
+  return getenv("SOUNDER_SIM_PIN3") ? 3 : 5;
+}
+
+const struct Station_Info stations[] = {
+  //                   buzzer     called    off_hook                      timeout  code  priority          dot  space
+  { STATION_NORMAL,   8, HIGH,   A0, LOW,   4, LOW,                      0,       "AA", PRIORITY_NORMAL,  0,   0   },
+  { STATION_NORMAL,   9, HIGH,   A1, LOW,   second_off_hook_pin(), LOW,  0,       "CO", PRIORITY_NORMAL,  60,  0   },
+};
+const int num_stations = sizeof(stations) / sizeof(stations[0]);
+const char station_table_name[] = "SOUNDER_SIM";
+const char ambience_00[] PROGMEM = "DS";
+const char * const ambience_messages[] PROGMEM = { ambience_00 };
+const int num_ambience_messages = 1;
+
+void setup()
+{
+  init_station_states();
+  init_sounder();
+}
+
+void loop()
+{
+  run_sounder();
+  run_station_states();
+}
+
+extern "C" void TIMER2_OVF_vect(void);
+
+static const unsigned long long run_micros = 20000000ULL;
+static const unsigned long long overflow_nsec = 31875;
+static const int pwm_periods_per_sample = 4;
+static const uint8_t pwm_silence = 128;
+
+// The click as an independent decode of the ADPCM data would play it
+static std::vector<uint8_t>
+reference_click(bool down)
+{
+  static const int index_change[8] = { -1, -1, -1, -1, 2, 4, 6, 8 };
+  const uint8_t *data = down ? sounder_down_adpcm : sounder_up_adpcm;
+  const int samples = down ? sounder_down_samples : sounder_up_samples;
+  int index = down ? sounder_down_start_index : sounder_up_start_index;
+  int predictor = 0;
+  std::vector<uint8_t> levels;
+  for (int ii = 0; ii < samples; ii++) {
+    const int code = (data[ii / 2] >> ((ii % 2) ? 4 : 0)) & 0x0f;
+    const int step = adpcm_step_table[index];
+    int diff = step >> 3;
+    if (code & 4) diff += step;
+    if (code & 2) diff += step >> 1;
+    if (code & 1) diff += step >> 2;
+    predictor += (code & 8) ? -diff : diff;
+    if (predictor > 32767) predictor = 32767;
+    if (predictor < -32768) predictor = -32768;
+    index += index_change[code & 7];
+    index = (index < 0) ? 0 : (index > 88) ? 88 : index;
+    levels.push_back((predictor >> 8) + 128);
+  }
+  return levels;
+}
+
+struct Click {
+  size_t start;   // index into the recorded levels of the first overflow after the edge
+  bool   down;
+};
+
+static unsigned pass_usec;
+
+static int
+run()
+{
+  sim_reset(1);
+  setup();
+  for (int ii = 0; ii < num_stations; ii++)
+    sim_input[stations[ii].called_pin_] = LOW;
+
+  const std::vector<uint8_t> reference[2] = { reference_click(false), reference_click(true) };
+  std::vector<uint8_t> levels;          // OCR2B after each handler entry
+  std::vector<Click> clicks;
+  bool buzzing[num_stations] = { };
+  unsigned long long entries = 0, next_overflow_nsec = 0;
+  const unsigned long long start = sim_micros;
+
+  while (sim_micros - start < run_micros) {
+    loop();
+    for (int ii = 0; ii < num_stations; ii++) {
+      const bool on = sim_output(stations[ii].buzzer_pin_);
+      if (on != buzzing[ii]) {
+        Click click = { levels.size(), on };
+        clicks.push_back(click);
+        buzzing[ii] = on;
+      }
+    }
+
+    sim_micros += pass_usec;
+    for (; next_overflow_nsec <= (sim_micros - start) * 1000; next_overflow_nsec += overflow_nsec) {
+      if (!(TIMSK2 & _BV(TOIE2)))
+        continue;
+      TIMER2_OVF_vect();
+      entries++;
+      levels.push_back(static_cast<uint8_t>(OCR2B));
+    }
+  }
+
+  // Each click plays its first level on the fourth overflow after the edge
+  unsigned bad = 0, checked = 0, unfinished = 0;
+  for (size_t cc = 0; cc < clicks.size(); cc++) {
+    const std::vector<uint8_t> &expect = reference[clicks[cc].down];
+    const size_t end = (cc + 1 < clicks.size()) ? clicks[cc + 1].start : levels.size();
+    size_t at = clicks[cc].start + pwm_periods_per_sample - 1;
+    for (size_t ss = 0; ss < expect.size(); ss++) {
+      for (int pp = 0; pp < pwm_periods_per_sample; pp++, at++) {
+        if (at >= end)
+          break;
+        checked++;
+        bad += (levels[at] != expect[ss]);
+      }
+    }
+    if (at >= end)
+      unfinished++;
+    else if ((levels[at] != pwm_silence) || (at + 1 != end))
+      bad++;
+  }
+
+  const double playing_sec = entries * overflow_nsec / 1e9;
+  printf("loop() every %4.1f msec: %zu clicks (%u cut short), %u of %u levels wrong; "
+         "%llu handler entries, %.1f s of %.0f s playing (%.0f%%)\n",
+         pass_usec / 1000.0, clicks.size(), unfinished, bad, checked, entries, playing_sec,
+         run_micros / 1e6, 100.0 * playing_sec / (run_micros / 1e6));
+  return (bad == 0) && (clicks.size() >= 20) ? 0 : 1;
+}
+
+static int
+run_pin3()
+{
+  sim_reset(1);
+  setup();
+  sim_input[stations[0].called_pin_] = LOW;
+  sim_run_until(sim_micros + 5000000ULL, 200);
+  const bool off = (TCCR2A == 0) && !(TIMSK2 & _BV(TOIE2)) && (sim_mode[3] != OUTPUT);
+  printf("hook switch on pin 3: sounder %s\n", off ? "stays off" : "STARTED");
+  return off ? 0 : 1;
+}
+
+int
+main(int argc, char **argv)
+{
+  if (getenv("SOUNDER_SIM_PIN3"))
+    return sim_run_child(run_pin3) ? 0 : 1;
+
+  printf("table %s, %d and %d sample clicks at %d PWM periods a sample\n", station_table_name,
+         sounder_down_samples, sounder_up_samples, pwm_periods_per_sample);
+  bool ok = true;
+  pass_usec = 200;
+  ok = sim_run_child(run) && ok;
+  pass_usec = 2000;
+  ok = sim_run_child(run) && ok;
+  pass_usec = 6000;
+  sim_run_child(run);
+
+  // The table is built when the program starts, so the pin 3 run is a fresh copy of it
+  fflush(stdout);
+  setenv("SOUNDER_SIM_PIN3", "1", 1);
+  if (fork() == 0) {
+    execv(argv[0], argv);
+    _exit(2);
+  }
+  int status;
+  wait(&status);
+  ok = ok && WIFEXITED(status) && (WEXITSTATUS(status) == 0);
+  return ok ? 0 : 1;
+}
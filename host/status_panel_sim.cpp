@@ -0,0 +1,222 @@
+// status_panel_sim.cpp -- the status panel's row scan run against the sketch's Morse output
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+// usage: status_panel_sim [-c isr_usec] trace.vcd
+//
+// Builds the sketch with WANT_STATUS_PANEL and WANT_VCD_TRACE around a small table of its own,
+// calls every station for a simulated minute (answering one of them halfway), and runs the
+// Timer1 compare handler at the rate OCR1A sets between loop() passes. Each handler entry is
+// charged isr_usec of CPU time (20 by default, over three times the estimate in
+// status_panel.cpp), taken from loop() by moving the clock on. After every entry exactly one
+// row must be lit, with the columns for its station's state. The handler rate and the CPU it
+// takes are reported, and the trace goes to trace.vcd for tools/check_morse_vcd.py to measure
+// how far the panel has moved the Morse edges.
+//
+// The program then starts itself again with each of three bad first row pins, which the panel
+// must refuse, leaving Timer1 and every panel pin alone while the stations still ring: A6 (no
+// port on a 328P), 30 (no such pin on this board) and 8 (a station's buzzer).
+
+#include "sim.h"
+#include "station_info.h"
+#include "station_states.h"
+#include "status_panel.h"
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+static uint8_t first_row_pin()
+{
+  const char *pin = getenv("STATUS_PANEL_SIM_ROW_PIN");
+  return pin ? atoi(pin) : 5;
+}
+
+const struct Station_Info stations[] = {
+  //                   buzzer     called    off_hook   timeout  code  priority          dot  space
+  { STATION_NORMAL,   8, HIGH,   A0, LOW,   2, LOW,   0,       "AA", PRIORITY_NORMAL,  0,   0   },
+  { STATION_NORMAL,   9, HIGH,   A1, LOW,   3, LOW,   0,       "CO", PRIORITY_NORMAL,  60,  300 },
+  { STATION_NORMAL,  10, HIGH,   A2, LOW,   4, LOW,   0,       "RX", PRIORITY_NORMAL,  150, 0   },
+};
+const int num_stations = sizeof(stations) / sizeof(stations[0]);
+const char station_table_name[] = "STATUS_PANEL_SIM";
+const char ambience_00[] PROGMEM = "DS";
+const char * const ambience_messages[] PROGMEM = { ambience_00 };
+const int num_ambience_messages = 1;
+
+const uint8_t status_panel_row_pins[] = { first_row_pin(), 6, 7 };
+const uint8_t status_panel_num_rows = sizeof(status_panel_row_pins) / sizeof(status_panel_row_pins[0]);
+const uint8_t status_panel_column_pins[status_panel_columns] = { 11, 12, 13, A3 };
+
+void setup()
+{
+  init_station_states();
+  init_status_panel();
+  trace_begin();
+}
+
+void loop()
+{
+  run_station_states();
+}
+
+extern "C" void TIMER1_COMPA_vect(void);
+
+static const unsigned long long run_micros = 60000000ULL;
+static const unsigned pass_usec = 100;
+static unsigned isr_usec = 20;
+static const char *vcd_path;
+
+static bool
+panel_started()
+{
+  return (TIMSK1 & _BV(OCIE1A)) != 0;
+}
+
+// The row that is lit (driven LOW), or -1 if none or more than one is
+static int
+lit_row()
+{
+  int lit = -1;
+  for (int row = 0; row < status_panel_num_rows; row++) {
+    const uint8_t pin = status_panel_row_pins[row];
+    if ((sim_mode[pin] == OUTPUT) && !sim_output(pin)) {
+      if (lit >= 0)
+        return -1;
+      lit = row;
+    }
+  }
+  return lit;
+}
+
+static int
+run()
+{
+  FILE *vcd = fopen(vcd_path, "w");
+  if (!vcd) {
+    perror(vcd_path);
+    return 1;
+  }
+  sim_reset(1);
+  sim_serial[0].tx_stream = vcd;
+  setup();
+  if (!panel_started()) {
+    printf("FAILED: the panel didn't start\n");
+    return 1;
+  }
+  for (int ii = 0; ii < num_stations; ii++)
+    sim_input[stations[ii].called_pin_] = LOW;
+
+  const unsigned long long period_usec = (OCR1A + 1) * 64ULL * 1000000ULL / F_CPU;
+  const unsigned long long start = sim_micros;
+  unsigned long long next_compare = start + period_usec, entries = 0;
+  unsigned wrong = 0;
+  uint8_t states_seen = 0;
+  while (sim_micros - start < run_micros) {
+    // The first station's phone is answered halfway through, and hung up ten seconds later
+    const unsigned long long now = sim_micros - start;
+    sim_input[stations[0].off_hook_pin_] = ((now >= run_micros / 2) && (now < run_micros / 2 + 10000000ULL)) ? LOW : HIGH;
+
+    loop();
+    sim_stream_tx();
+    sim_micros += pass_usec;
+    for (; next_compare <= sim_micros; next_compare += period_usec) {
+      TIMER1_COMPA_vect();
+      entries++;
+      sim_micros += isr_usec;
+
+      const int row = lit_row();
+      if (row < 0) {
+        wrong++;
+        continue;
+      }
+      const uint8_t state = const_cast<Station_Info *>(&stations[row])->state();
+      const uint8_t expect = (state == IDLE) ? 0 : (1 << (state - RING_WAITING));
+      uint8_t columns = 0;
+      for (int col = 0; col < status_panel_columns; col++)
+        columns |= sim_output(status_panel_column_pins[col]) ? (1 << col) : 0;
+      wrong += (columns != expect);
+      states_seen |= 1 << state;
+    }
+  }
+  fclose(vcd);
+
+  const double rate = entries / (run_micros / 1e6);
+  printf("%u rows: OCR1A %u, handler every %llu usec, %.1f a second; at %u usec each, %.2f%% of the CPU\n",
+         status_panel_num_rows, static_cast<unsigned>(OCR1A), period_usec, rate, isr_usec,
+         100.0 * rate * isr_usec / 1e6);
+  printf("%llu scans, %u with the wrong row or columns lit, states shown %02x; trace in %s\n",
+         entries, wrong, states_seen, vcd_path);
+  const bool ok = (wrong == 0) && (rate >= 0.99 * 100 * status_panel_num_rows) &&
+                  (states_seen & (1 << RING_PLAYING)) && (states_seen & (1 << TALKING));
+  printf("%s\n", ok ? "ok" : "FAILED");
+  return ok ? 0 : 1;
+}
+
+// With a bad row pin, nothing of the panel's may be set up, and the stations carry on
+static int
+run_rejected()
+{
+  sim_reset(1);
+  setup();
+  sim_input[stations[0].called_pin_] = LOW;
+  bool rang = false;
+  for (unsigned long long until = sim_micros + 10000000ULL; sim_micros < until; sim_micros += pass_usec) {
+    loop();
+    rang = rang || sim_output(stations[0].buzzer_pin_);
+  }
+
+  bool untouched = !panel_started();
+  for (int row = 1; row < status_panel_num_rows; row++)
+    untouched = untouched && (sim_mode[status_panel_row_pins[row]] != OUTPUT);
+  for (int col = 0; col < status_panel_columns; col++)
+    untouched = untouched && (sim_mode[status_panel_column_pins[col]] != OUTPUT);
+  printf("row pin %u: panel %s, station %s\n", status_panel_row_pins[0],
+         untouched ? "refused" : "STARTED", rang ? "still rings" : "SILENT");
+  return (untouched && rang) ? 0 : 1;
+}
+
+int
+main(int argc, char **argv)
+{
+  if (getenv("STATUS_PANEL_SIM_ROW_PIN"))
+    return sim_run_child(run_rejected) ? 0 : 1;
+
+  const bool cost_given = (argc == 4) && !strcmp(argv[1], "-c");
+  if (argc != (cost_given ? 4 : 2)) {
+    fprintf(stderr, "usage: status_panel_sim [-c isr_usec] trace.vcd\n");
+    return 2;
+  }
+  if (cost_given)
+    isr_usec = atoi(argv[2]);
+  vcd_path = argv[argc - 1];
+  bool ok = sim_run_child(run);
+
+  // The pin lists are built when the program starts, so each bad pin needs a fresh copy of it
+  static const char * const bad_pins[] = { "20", "30", "8" };
+  for (size_t ii = 0; ii < sizeof(bad_pins) / sizeof(bad_pins[0]); ii++) {
+    fflush(stdout);
+    setenv("STATUS_PANEL_SIM_ROW_PIN", bad_pins[ii], 1);
+    if (fork() == 0) {
+      execv(argv[0], argv);
+      _exit(2);
+    }
+    int status;
+    wait(&status);
+    ok = ok && WIFEXITED(status) && (WEXITSTATUS(status) == 0);
+  }
+  return ok ? 0 : 1;
+}
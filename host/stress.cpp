@@ -0,0 +1,530 @@
+// stress.cpp -- random stress testing of the station state machine, with shrinking
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+// usage: stress [-j workers] [-n sequences] [-t seconds] [-s seed] [-e events]
+//               [--max-wait-sec N] [--max-ring-sec N] [-o reproducer]
+//        stress --replay reproducer
+//
+// Each sequence is a random list of input changes (a caller picking up or hanging up, a station
+// answering), played into the sketch with the time between loop() passes also varied at
+// random. After every pass the board is checked against the rules the state machine is meant to
+// keep, which are watched from the outside, through the pins, as well as through the stations'
+// states:
+//
+//   - at most one station is in RING_PLAYING, and at most one buzzer is sounding
+//   - a buzzer only sounds while its station is in RING_PLAYING
+//   - no ring lasts longer than --max-ring-sec
+//   - no station other than an ambience station waits longer than --max-wait-sec for a ring
+//   - a normal station that is called and on hook doesn't stay IDLE
+//   - a station that has been answered doesn't keep buzzing
+//
+// Every sequence runs in a fresh child process, since the sketch keeps its state in globals.
+// The workers (-j) are separate processes with their own seeds. When a sequence breaks a rule
+// it is shrunk -- input changes are dropped and delays cut for as long as the same rule still
+// breaks -- and the shortest version is written to a reproducer file, which "--replay" plays
+// back with a trace of every state change and buzzer edge.
+
+#include "sim.h"
+#include "station_info.h"
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <string>
+#include <vector>
+
+struct Event {
+  uint32_t delay_msec;   // after the previous event
+  uint8_t  pin;
+  uint8_t  level;
+};
+
+struct Sequence {
+  uint32_t           seed;        // seeds random() in the sketch and the loop() pass lengths
+  std::vector<Event> events;
+  uint32_t           tail_msec;   // how long to keep running after the last event
+};
+
+struct Result {
+  bool               failed;
+  char               rule[64];      // which rule broke, for comparing shrunk sequences
+  char               message[192];
+  unsigned long long loops;
+  unsigned long long sim_msec;
+};
+
+// Per-worker totals, shared with the parent process
+struct Worker_Stats {
+  unsigned long long sequences;
+  unsigned long long loops;
+  unsigned long long sim_msec;
+  bool               failed;
+};
+
+static unsigned long max_wait_msec = 180000;
+static unsigned long max_ring_msec = 120000;
+static const unsigned long answered_msec = 1000;  // time allowed to react to an input change
+
+static bool verbose = false;
+
+static Station_Info *
+station(int ii)
+{
+  return const_cast<Station_Info *>(&stations[ii]);
+}
+
+static bool
+buzzer_sounding(Station_Info *s)
+{
+  return sim_output(s->buzzer_pin_) == (s->buzzer_active_ == HIGH);
+}
+
+static bool
+input_active(uint8_t pin, uint8_t active)
+{
+  return sim_input[pin] == (active & ~ANALOG_IN);
+}
+
+// The input pins a sequence may change: every station's called and off_hook inputs
+static std::vector<uint8_t>
+input_pins()
+{
+  std::vector<uint8_t> pins;
+  for (int ii = 0; ii < num_stations; ii++) {
+    if (station(ii)->is_ambience())
+      continue;
+    pins.push_back(station(ii)->called_pin_);
+    pins.push_back(station(ii)->off_hook_pin_);
+  }
+  return pins;
+}
+
+static const char *
+state_name(Station_States state)
+{
+  static const char * const names[] = { "IDLE", "RING_WAITING", "RING_PLAYING", "TALKING", "HANGUP_WAIT" };
+  return (state < LAST_UNUSED_STATE) ? names[state] : "?";
+}
+
+// Watches the board from outside after every loop() pass
+class Checker {
+ public:
+  Checker(Result *result) : result_(result)
+  {
+    for (int ii = 0; ii < num_stations; ii++) {
+      state_[ii] = station(ii)->state();
+      buzzing_[ii] = buzzer_sounding(station(ii));
+      since_[ii] = wait_since_[ii] = 0;
+    }
+    for (int ii = 0; ii < NUM_DIGITAL_PINS; ii++)
+      input_since_[ii] = 0;
+  }
+
+  void input_changed(uint8_t pin) { input_since_[pin] = sim_micros / 1000; }
+
+  // Returns false once a rule has broken
+  bool check()
+  {
+    const unsigned long long now = sim_micros / 1000;
+    int playing = 0, sounding = 0;
+
+    for (int ii = 0; ii < num_stations; ii++) {
+      Station_Info * const s = station(ii);
+      const Station_States state = s->state();
+      const bool buzzing = buzzer_sounding(s);
+
+      if (state != state_[ii]) {
+        if (verbose)
+          printf("%10llu %-4s %s -> %s\n", now, s->station_code(), state_name(state_[ii]), state_name(state));
+        // The wait is counted from being called, or from the end of the last ring
+        if ((state == RING_WAITING) || (state_[ii] == RING_PLAYING))
+          wait_since_[ii] = now;
+        since_[ii] = now;
+        state_[ii] = state;
+      }
+      if (buzzing != buzzing_[ii]) {
+        if (verbose)
+          printf("%10llu %-4s buzzer %s\n", now, s->station_code(), buzzing ? "on" : "off");
+        buzzing_[ii] = buzzing;
+      }
+
+      if (state == RING_PLAYING)
+        playing++;
+      if (buzzing)
+        sounding++;
+
+      if (buzzing && (state != RING_PLAYING))
+        return fail("buzzer sounding while not ringing", s);
+      if ((state == RING_PLAYING) && (now - since_[ii] > max_ring_msec))
+        return fail("ring too long", s);
+      if ((state == RING_WAITING) && !s->is_ambience() && (now - wait_since_[ii] > max_wait_msec))
+        return fail("station starved", s);
+
+      if (s->is_ambience())
+        continue;
+      const bool called = input_active(s->called_pin_, s->called_active_);
+      const bool off_hook = input_active(s->off_hook_pin_, s->off_hook_active_);
+      const unsigned long long inputs_since = (input_since_[s->called_pin_] > input_since_[s->off_hook_pin_]) ?
+                                                input_since_[s->called_pin_] : input_since_[s->off_hook_pin_];
+      const bool settled = (now - inputs_since > answered_msec) && (now - since_[ii] > answered_msec);
+      if (settled && (station_type(s) == STATION_NORMAL) && called && !off_hook && (state == IDLE))
+        return fail("called station stays idle", s);
+      if (settled && off_hook && buzzing)
+        return fail("answered station still buzzing", s);
+    }
+
+    if (playing > 1)
+      return fail("two stations in RING_PLAYING", 0);
+    if (sounding > 1)
+      return fail("two buzzers sounding", 0);
+    return true;
+  }
+
+ private:
+  static Station_Type station_type(Station_Info *s) { return s->station_type_; }
+
+  bool fail(const char *rule, Station_Info *s)
+  {
+    result_->failed = true;
+    snprintf(result_->rule, sizeof(result_->rule), "%s", rule);
+    snprintf(result_->message, sizeof(result_->message), "%s%s%s at %llu msec", rule,
+             s ? ": " : "", s ? s->station_code() : "", sim_micros / 1000);
+    if (verbose)
+      printf("%10llu RULE BROKEN: %s\n", sim_micros / 1000, result_->message);
+    return false;
+  }
+
+  Result             *result_;
+  Station_States      state_[32];
+  bool                buzzing_[32];
+  unsigned long long  since_[32];        // when the station entered its current state
+  unsigned long long  wait_since_[32];   // when the station started waiting for a ring
+  unsigned long long  input_since_[NUM_DIGITAL_PINS];
+};
+
+// A small generator of our own, so that sequences are the same on every host
+struct Random {
+  uint32_t state;
+  Random(uint32_t seed) : state(seed ? seed : 1) { }
+  uint32_t next() { state ^= state << 13; state ^= state >> 17; state ^= state << 5; return state; }
+  uint32_t below(uint32_t n) { return next() % n; }
+};
+
+// Plays a sequence into the sketch. Only call this in a fresh process.
+static void
+run_sequence(const Sequence &seq, Result *result)
+{
+  memset(result, 0, sizeof(*result));
+  sim_reset(seq.seed);
+  setup();
+
+  Checker checker(result);
+  Random steps(seq.seed ^ 0x5a5a5a5a);
+  unsigned long long until = sim_micros;
+
+  for (size_t ev = 0; ev <= seq.events.size(); ev++) {
+    until += 1000ULL * ((ev < seq.events.size()) ? seq.events[ev].delay_msec : seq.tail_msec);
+    while (sim_micros < until) {
+      loop();
+      result->loops++;
+      if (!checker.check())
+        goto done;
+      // Vary the time between passes, from a quick loop() to a slow one held up by serial output
+      sim_micros += (steps.below(8) == 0) ? 1000 + steps.below(4000) : 100 + steps.below(900);
+    }
+    if (ev < seq.events.size()) {
+      const Event &event = seq.events[ev];
+      if (verbose)
+        printf("%10llu pin %d -> %s\n", sim_micros / 1000, event.pin, event.level ? "HIGH" : "LOW");
+      sim_input[event.pin] = event.level;
+      checker.input_changed(event.pin);
+    }
+  }
+ done:
+  result->sim_msec = sim_micros / 1000;
+}
+
+// Runs a sequence in a child process, so that each one starts from a freshly reset sketch
+static void
+run_sequence_forked(const Sequence &seq, Result *shared)
+{
+  fflush(stdout);
+  const pid_t pid = fork();
+  if (pid == 0) {
+    run_sequence(seq, shared);
+    _exit(0);
+  }
+  int status;
+  waitpid(pid, &status, 0);
+  if (!WIFEXITED(status) || (WEXITSTATUS(status) != 0)) {
+    shared->failed = true;
+    snprintf(shared->rule, sizeof(shared->rule), "sketch crashed");
+    snprintf(shared->message, sizeof(shared->message), "sketch crashed (status %d)", status);
+  }
+}
+
+static Sequence
+random_sequence(uint32_t seed, int num_events, const std::vector<uint8_t> &pins)
+{
+  Random random(seed);
+  Sequence seq;
+  seq.seed = seed;
+  seq.tail_msec = 60000 + random.below(max_wait_msec + 60000);
+
+  uint8_t level[NUM_DIGITAL_PINS];
+  memset(level, HIGH, sizeof(level));
+  for (int ii = 0; ii < num_events; ii++) {
+    Event event;
+    // Mostly quick changes, with the occasional long pause
+    event.delay_msec = (random.below(4) == 0) ? random.below(60000) : random.below(2000);
+    event.pin = pins[random.below(pins.size())];
+    event.level = level[event.pin] = !level[event.pin];
+    seq.events.push_back(event);
+  }
+  return seq;
+}
+
+static bool
+still_fails(const Sequence &seq, const char *rule, Result *shared)
+{
+  run_sequence_forked(seq, shared);
+  return shared->failed && (strcmp(shared->rule, rule) == 0);
+}
+
+// Makes a failing sequence as short as it can while it still breaks the same rule
+static Sequence
+shrink(Sequence seq, Result *shared)
+{
+  run_sequence_forked(seq, shared);
+  const std::string rule = shared->rule;
+
+  // Drop runs of events, halving the run length each time nothing more can go
+  for (size_t chunk = (seq.events.size() + 1) / 2; chunk >= 1; chunk /= 2) {
+    for (size_t start = 0; start < seq.events.size(); ) {
+      Sequence trial = seq;
+      const size_t end = (start + chunk < trial.events.size()) ? start + chunk : trial.events.size();
+      trial.events.erase(trial.events.begin() + start, trial.events.begin() + end);
+      if (still_fails(trial, rule.c_str(), shared))
+        seq = trial;
+      else
+        start += chunk;
+    }
+    if (chunk == 1)
+      break;
+  }
+
+  // Then cut each delay, and the tail, as short as they will go
+  for (size_t ii = 0; ii <= seq.events.size(); ii++) {
+    uint32_t &delay = (ii < seq.events.size()) ? seq.events[ii].delay_msec : seq.tail_msec;
+    while (delay > 0) {
+      const uint32_t was = delay;
+      delay = (delay > 20) ? delay / 2 : 0;
+      if (!still_fails(seq, rule.c_str(), shared)) {
+        delay = was;
+        break;
+      }
+    }
+  }
+
+  run_sequence_forked(seq, shared);
+  return seq;
+}
+
+static bool
+write_reproducer(const char *path, const Sequence &seq, const Result &result)
+{
+  FILE *out = fopen(path, "w");
+  if (!out)
+    return false;
+  fprintf(out, "# station_buzzers stress reproducer, play with: stress --replay %s\n", path);
+  fprintf(out, "table %s\n", station_table_name);
+  fprintf(out, "rule %s\n", result.rule);
+  fprintf(out, "max_wait_msec %lu\n", max_wait_msec);
+  fprintf(out, "max_ring_msec %lu\n", max_ring_msec);
+  fprintf(out, "seed %u\n", seq.seed);
+  fprintf(out, "tail_msec %u\n", seq.tail_msec);
+  for (size_t ii = 0; ii < seq.events.size(); ii++)
+    fprintf(out, "event %u %u %u\n", seq.events[ii].delay_msec, seq.events[ii].pin, seq.events[ii].level);
+  fclose(out);
+  return true;
+}
+
+static bool
+read_reproducer(const char *path, Sequence *seq)
+{
+  FILE *in = fopen(path, "r");
+  if (!in) {
+    perror(path);
+    return false;
+  }
+  char line[256], word[64];
+  while (fgets(line, sizeof(line), in)) {
+    unsigned a, b, c;
+    if ((line[0] == '#') || (sscanf(line, "%63s", word) != 1))
+      continue;
+    if (!strcmp(word, "table")) {
+      char table[64];
+      if ((sscanf(line, "table %63s", table) == 1) && strcmp(table, station_table_name))
+        fprintf(stderr, "warning: reproducer is for table %s, this build has %s\n", table, station_table_name);
+    } else if (sscanf(line, "max_wait_msec %u", &a) == 1) {
+      max_wait_msec = a;
+    } else if (sscanf(line, "max_ring_msec %u", &a) == 1) {
+      max_ring_msec = a;
+    } else if (sscanf(line, "seed %u", &a) == 1) {
+      seq->seed = a;
+    } else if (sscanf(line, "tail_msec %u", &a) == 1) {
+      seq->tail_msec = a;
+    } else if (sscanf(line, "event %u %u %u", &a, &b, &c) == 3) {
+      Event event = { a, static_cast<uint8_t>(b), static_cast<uint8_t>(c) };
+      seq->events.push_back(event);
+    }
+  }
+  fclose(in);
+  return true;
+}
+
+static double
+wall_seconds()
+{
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+static void
+usage()
+{
+  fprintf(stderr,
+          "usage: stress [-j workers] [-n sequences] [-t seconds] [-s seed] [-e events]\n"
+          "              [--max-wait-sec N] [--max-ring-sec N] [-o reproducer]\n"
+          "       stress --replay reproducer\n");
+  exit(2);
+}
+
+int
+main(int argc, char **argv)
+{
+  int workers = 1;
+  unsigned long long num_sequences = 1000;
+  double seconds = 0;
+  uint32_t seed = 1;
+  int num_events = 40;
+  const char *reproducer = "stress.repro";
+  const char *replay = 0;
+
+  for (int ii = 1; ii < argc; ii++) {
+    const char *arg = argv[ii];
+    const char *value = (ii + 1 < argc) ? argv[ii + 1] : 0;
+    if (!value)
+      usage();
+    if (!strcmp(arg, "-j"))                    workers = atoi(value);
+    else if (!strcmp(arg, "-n"))               num_sequences = strtoull(value, 0, 0);
+    else if (!strcmp(arg, "-t"))               seconds = atof(value);
+    else if (!strcmp(arg, "-s"))               seed = strtoul(value, 0, 0);
+    else if (!strcmp(arg, "-e"))               num_events = atoi(value);
+    else if (!strcmp(arg, "-o"))               reproducer = value;
+    else if (!strcmp(arg, "--max-wait-sec"))   max_wait_msec = 1000UL * atoi(value);
+    else if (!strcmp(arg, "--max-ring-sec"))   max_ring_msec = 1000UL * atoi(value);
+    else if (!strcmp(arg, "--replay"))         replay = value;
+    else usage();
+    ii++;
+  }
+
+  if (replay) {
+    Sequence seq;
+    if (!read_reproducer(replay, &seq))
+      return 2;
+    Result result;
+    verbose = true;
+    run_sequence(seq, &result);
+    printf("%s\n", result.failed ? result.message : "no rule broken");
+    return result.failed ? 1 : 0;
+  }
+
+  if ((workers < 1) || (num_events < 1))
+    usage();
+
+  const std::vector<uint8_t> pins = input_pins();
+  Worker_Stats * const stats = static_cast<Worker_Stats *>(
+      mmap(0, workers * sizeof(Worker_Stats), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0));
+  volatile bool * const stop = static_cast<volatile bool *>(
+      mmap(0, sizeof(bool), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0));
+  memset(stats, 0, workers * sizeof(Worker_Stats));
+  *stop = false;
+
+  printf("table %s, %d worker%s, seed %u, %d events per sequence\n", station_table_name, workers,
+         (workers == 1) ? "" : "s", seed, num_events);
+  fflush(stdout);
+  const double start = wall_seconds();
+
+  std::vector<pid_t> pids;
+  for (int worker = 0; worker < workers; worker++) {
+    const pid_t pid = fork();
+    if (pid != 0) {
+      pids.push_back(pid);
+      continue;
+    }
+
+    Result * const shared = static_cast<Result *>(
+        mmap(0, sizeof(Result), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0));
+    Worker_Stats &mine = stats[worker];
+    // Worker w runs sequences w, w + workers, w + 2*workers, ... each with its own seed
+    for (unsigned long long nn = worker; nn < num_sequences; nn += workers) {
+      if (*stop || ((seconds > 0) && (wall_seconds() - start > seconds)))
+        break;
+      const Sequence seq = random_sequence(seed * 2654435761u + nn, num_events, pins);
+      run_sequence_forked(seq, shared);
+      mine.sequences++;
+      mine.loops += shared->loops;
+      mine.sim_msec += shared->sim_msec;
+      if (!shared->failed)
+        continue;
+
+      *stop = true;
+      mine.failed = true;
+      printf("sequence %llu (seed %u): %s\n", nn, seq.seed, shared->message);
+      printf("shrinking %zu events...\n", seq.events.size());
+      const Sequence small = shrink(seq, shared);
+      char path[256];
+      snprintf(path, sizeof(path), (workers == 1) ? "%s" : "%s.%d", reproducer, worker);
+      if (write_reproducer(path, small, *shared))
+        printf("shrunk to %zu events: %s\nreproducer written to %s\n", small.events.size(), shared->message, path);
+      break;
+    }
+    fflush(stdout);
+    _exit(0);
+  }
+
+  for (size_t ii = 0; ii < pids.size(); ii++)
+    waitpid(pids[ii], 0, 0);
+
+  const double elapsed = wall_seconds() - start;
+  Worker_Stats total = { 0, 0, 0, false };
+  for (int worker = 0; worker < workers; worker++) {
+    total.sequences += stats[worker].sequences;
+    total.loops += stats[worker].loops;
+    total.sim_msec += stats[worker].sim_msec;
+    total.failed = total.failed || stats[worker].failed;
+  }
+  printf("%llu sequences, %.1f simulated hours, %llu loop() passes in %.1f s: "
+         "%.0f sequences/s, %.2f million loop() passes/s\n",
+         total.sequences, total.sim_msec / 3600000.0, total.loops, elapsed,
+         total.sequences / elapsed, total.loops / elapsed / 1e6);
+  printf("%s\n", total.failed ? "FAILED" : "no rule broken");
+  return total.failed ? 1 : 0;
+}
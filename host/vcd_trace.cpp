@@ -0,0 +1,121 @@
+// vcd_trace.cpp -- a VCD trace of stations with their own code speeds
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+// usage: vcd_trace [-t seconds] trace.vcd
+//
+// Builds the sketch with WANT_VCD_TRACE around a small table of its own, in which each station
+// has a different code speed, calls every station for a simulated minute (or the given number
+// of seconds), and writes what goes out of the serial port to trace.vcd. "make check" then runs
+// tools/check_morse_vcd.py on it, which has to pick each buzzer's timing up from the trace
+// header to pass.
+//
+// The trace is streamed to the file after every loop() pass rather than kept until the end, so
+// a run of any length takes the same memory. The program reports the most trace that was ever
+// waiting to be written, and the process's peak RSS after the first tenth of the run and at
+// the end, and fails if the RSS has grown by more than rss_growth_kb in between.
+
+#include "sim.h"
+#include "station_info.h"
+#include "station_states.h"
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+
+const struct Station_Info stations[] = {
+  //                   buzzer     called    off_hook   timeout  code  priority          dot  space
+  { STATION_NORMAL,   8, HIGH,   A0, LOW,   2, LOW,   0,       "AA", PRIORITY_NORMAL,  0,   0   },
+  { STATION_NORMAL,   9, HIGH,   A1, LOW,   3, LOW,   0,       "CO", PRIORITY_NORMAL,  60,  300 },
+  { STATION_NORMAL,  10, HIGH,   A2, LOW,   4, LOW,   0,       "RX", PRIORITY_NORMAL,  150, 0   },
+};
+const int num_stations = sizeof(stations) / sizeof(stations[0]);
+const char station_table_name[] = "VCD_TRACE";
+const char ambience_00[] PROGMEM = "DS";
+const char * const ambience_messages[] PROGMEM = { ambience_00 };
+const int num_ambience_messages = 1;
+
+void setup()
+{
+  init_station_states();
+  trace_begin();
+}
+
+void loop()
+{
+  run_station_states();
+}
+
+static const unsigned pass_usec = 100;
+static const long rss_growth_kb = 64;
+static unsigned long long run_micros = 60000000ULL;
+static const char *vcd_path;
+
+static long
+peak_rss_kb()
+{
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+static int
+run()
+{
+  FILE *vcd = fopen(vcd_path, "w");
+  if (!vcd) {
+    perror(vcd_path);
+    return 1;
+  }
+  sim_reset(1);
+  sim_serial[0].tx_stream = vcd;
+  setup();
+  for (int ii = 0; ii < num_stations; ii++)
+    sim_input[stations[ii].called_pin_] = LOW;
+  const unsigned long long start = sim_micros;
+  sim_run_until(start + run_micros / 10, pass_usec);
+  const long early_rss_kb = peak_rss_kb();
+  sim_run_until(start + run_micros, pass_usec);
+  const long end_rss_kb = peak_rss_kb();
+
+  const long written = ftell(vcd);
+  if (fclose(vcd) != 0) {
+    perror(vcd_path);
+    return 1;
+  }
+  printf("%ld bytes of trace written to %s over %.0f s, at most %zu held at once; peak RSS %ld KB after %.0f s, %ld KB at the end\n",
+         written, vcd_path, run_micros / 1e6, sim_serial[0].tx_stream_max, early_rss_kb, run_micros / 1e7, end_rss_kb);
+  if (end_rss_kb - early_rss_kb > rss_growth_kb) {
+    printf("FAILED: memory grew by %ld KB\n", end_rss_kb - early_rss_kb);
+    return 1;
+  }
+  return 0;
+}
+
+int
+main(int argc, char **argv)
+{
+  if ((argc == 4) && !strcmp(argv[1], "-t")) {
+    run_micros = 1000000ULL * atof(argv[2]);
+    argv += 2;
+    argc -= 2;
+  }
+  if ((argc != 2) || (run_micros == 0)) {
+    fprintf(stderr, "usage: vcd_trace [-t seconds] trace.vcd\n");
+    return 2;
+  }
+  vcd_path = argv[1];
+  return sim_run_child(run) ? 0 : 1;
+}
@@ -0,0 +1,135 @@
+// memory_stats.cpp -- optional SRAM usage instrumentation for station_buzzers
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+#include "memory_stats.h"
+#include "DebugSerial.h"
+
+#ifdef WANT_MEMORY_STATS
+
+#ifndef WANT_REAL_SERIAL
+#error "WANT_MEMORY_STATS reports over the serial port; enable WANT_REAL_SERIAL in DebugSerial.h"
+#endif
+
+// Symbols provided by avr-libc and the linker script (or, on the host, by sim.cpp)
+extern uint8_t __heap_start;
+extern char *__brkval;
+struct __freelist {
+  size_t sz;
+  struct __freelist *nx;
+};
+extern struct __freelist *__flp;
+
+// The paint byte is a macro as well, so that paint_stack()'s assembler can use it
+#define STACK_PAINT 0xc5
+#define STACK_PAINT_STR(x) #x
+#define STACK_PAINT_XSTR(x) STACK_PAINT_STR(x)
+static const uint8_t stack_paint = STACK_PAINT;
+static const unsigned memory_check_msec = 1000;
+static const unsigned memory_low_water_bytes = 128;
+
+static unsigned long check_millis;
+static bool low_water_reported = false;
+
+// paint_stack: runs from the .init3 section, after the stack pointer is set up but before the
+// C++ constructors and setup(), and fills everything between the static data and the top of
+// RAM with stack_paint. It must not use the stack itself, hence "naked". GCC only supports
+// basic asm in a naked function -- a C loop there works only for as long as the optimizer
+// happens to keep everything in registers and not call memset() -- so the loop is written out
+// with the pointer in Z. Nothing has been set up for C yet, so the registers are free to use.
+// (host/assemble_paint_stack.sh assembles it for each of the boards.)
+//
+// The host simulation has no start-up code; sim_reset() calls the plain C version instead.
+#ifdef __AVR__
+void paint_stack() __attribute__((naked, used, section(".init3")));
+void
+paint_stack()
+{
+  __asm__ __volatile__ (
+    "    ldi  r30, lo8(__heap_start)\n"
+    "    ldi  r31, hi8(__heap_start)\n"
+    "    ldi  r24, " STACK_PAINT_XSTR(STACK_PAINT) "\n"
+    "    ldi  r25, hi8(" STACK_PAINT_XSTR(RAMEND) " + 1)\n"
+    "1:  st   Z+, r24\n"
+    "    cpi  r30, lo8(" STACK_PAINT_XSTR(RAMEND) " + 1)\n"
+    "    cpc  r31, r25\n"
+    "    brne 1b\n"
+  );
+}
+#else
+void
+paint_stack()
+{
+  for (uint8_t *p = &__heap_start; p <= reinterpret_cast<uint8_t *>(RAMEND); p++)
+    *p = stack_paint;
+}
+#endif
+
+static uint8_t *
+heap_top()
+{
+  return (__brkval != 0) ? reinterpret_cast<uint8_t *>(__brkval) : &__heap_start;
+}
+
+// The number of bytes above the heap that the stack has never touched
+unsigned
+memory_free_min_bytes()
+{
+  const uint8_t *p = heap_top();
+  while ((p <= reinterpret_cast<uint8_t *>(RAMEND)) && (*p == stack_paint))
+    p++;
+  return p - heap_top();
+}
+
+void
+report_memory_stats()
+{
+  const unsigned free_now = reinterpret_cast<uint8_t *>(SP) + 1 - heap_top();
+  const unsigned free_min = memory_free_min_bytes();
+  const unsigned stack_max = reinterpret_cast<uint8_t *>(RAMEND) - heap_top() + 1 - free_min;
+
+  // Walk the malloc() free list to see how fragmented the heap is
+  unsigned free_list_bytes = 0;
+  unsigned largest_free = 0;
+  for (struct __freelist *fp = __flp; fp != 0; fp = fp->nx) {
+    const unsigned block = fp->sz + sizeof(size_t);
+    free_list_bytes += block;
+    if (block > largest_free)
+      largest_free = block;
+  }
+
+  Serial.print(F("MEMORY free_now="));      Serial.print(free_now);
+  Serial.print(F(" free_min="));            Serial.print(free_min);
+  Serial.print(F(" stack_max="));           Serial.print(stack_max);
+  Serial.print(F(" heap_used="));           Serial.print(heap_top() - &__heap_start - free_list_bytes);
+  Serial.print(F(" heap_free_list="));      Serial.print(free_list_bytes);
+  Serial.print(F(" heap_largest_free="));   Serial.println(largest_free);
+}
+
+void
+run_memory_stats()
+{
+  const unsigned long now_millis = millis();
+  if (low_water_reported || (now_millis - check_millis < memory_check_msec))
+    return;
+  check_millis = now_millis;
+
+  if (memory_free_min_bytes() < memory_low_water_bytes) {
+    Serial.print(F("WARNING: low memory, "));
+    report_memory_stats();
+    low_water_reported = true;
+  }
+}
+
+#endif
@@ -0,0 +1,48 @@
+// memory_stats.h -- optional SRAM usage instrumentation for station_buzzers
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+#ifndef INCLUDED_memory_stats
+#define INCLUDED_memory_stats
+
+#include <Arduino.h>
+
+// The 328P has only 2K of SRAM, shared by the station table, the heap and the stack. With
+// WANT_MEMORY_STATS enabled (the #define line below is the *last* of the pair), all of the free
+// SRAM is painted with a known pattern at boot, before setup() runs, so that we can later tell
+// how deep the stack has ever reached. An 'M' command on the serial console prints a line like
+//
+//   MEMORY free_now=1210 free_min=1102 stack_max=96 heap_used=0 heap_free_list=0 heap_largest_free=0
+//
+// and a warning is printed (once) if free_min ever falls below memory_low_water_bytes. Use it
+// on a board loaded with its full station table and message list to see how much room is left.
+// host/memory_stats_sim checks the report and the warning against a heap and stack built in the
+// simulated SRAM.
+#define WANT_MEMORY_STATS
+#undef WANT_MEMORY_STATS
+
+#ifdef WANT_MEMORY_STATS
+
+void run_memory_stats();
+void report_memory_stats();
+unsigned memory_free_min_bytes();  // the least free SRAM there has ever been
+
+#else
+
+inline void run_memory_stats() { }
+inline void report_memory_stats() { }
+
+#endif
+
+#endif
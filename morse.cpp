@@ -15,88 +15,99 @@
 
 #include "morse.h"
 #include "Arduino.h"
+#include "buzzer_output.h"
+#include "profile.h"
+#include "sounder.h"
+#include "trace.h"
 #include "DebugSerial.h"
 
-static const unsigned dot_time = 100; // milliseconds
+static const unsigned default_dot_time = 100; // milliseconds
 
-static const char * morse_table[128];
-bool morse_table_initialized = false;
-
-static void
-initialize_morse_table()
-{
-  if (!morse_table_initialized) {
-    for (int ii = 0; ii < 128; ii++) {
-      morse_table[ii] = 0;
-    }
-    morse_table[' '] = " ";
-    morse_table['A'] = ".-";
-    morse_table['B'] = "-...";
-    morse_table['C'] = ".,.";
-    morse_table['D'] = "-..";
-    morse_table['E'] = ".";
-    morse_table['F'] = ".-.";
-    morse_table['G'] = "--.";
-    morse_table['H'] = "....";
-    morse_table['I'] = "..";
-    morse_table['J'] = "-.-.";
-    morse_table['K'] = "-.-";
-    morse_table['L'] = "L";
-    morse_table['M'] = "--";
-    morse_table['N'] = "-.";
-    morse_table['O'] = ",.";
-    morse_table['P'] = ".....";
-    morse_table['Q'] = "..-.";
-    morse_table['R'] = ",..";
-    morse_table['S'] = "...";
-    morse_table['T'] = "-";
-    morse_table['U'] = "..-";
-    morse_table['V'] = "...-";
-    morse_table['W'] = ".--";
-    morse_table['X'] = ".-..";
-    morse_table['Y'] = ".,..";
-    morse_table['Z'] = "..,.";
-
-    morse_table['0'] = "0";
-    morse_table['1'] = ".--.";
-    morse_table['2'] = "..-..";
-    morse_table['3'] = "...-.";
-    morse_table['4'] = "....-";
-    morse_table['5'] = "---";
-    morse_table['6'] = "......";
-    morse_table['7'] = "--..";
-    morse_table['8'] = "-....";
-    morse_table['9'] = "-..-";
-
-    morse_table['.'] = "..--..";
-    morse_table[','] = ".-.-";
-    morse_table['?'] = "-..-.";
-    morse_table['\''] = ".----.";
-    morse_table['!'] = "---.";
-    morse_table['/'] = "-..-.";
-    morse_table['('] = morse_table[')'] = "-.--.-";
-    morse_table['&'] = ",...";
-    morse_table[':'] = "---...";
-    morse_table[';'] = "-.-.-.";
-    morse_table['='] = "-...-";
-    morse_table['-'] = "-....-";
-    morse_table['_'] = "..__._";
-    morse_table['"'] = ".-..-.";
-    morse_table['@'] = ".--.-.";
-    morse_table_initialized = true;
-  }
-}
+// morse_table: the American Morse pattern for each character from ' ' through '_', kept in
+// program memory so that it costs no SRAM. Characters outside that range, and the ones with an
+// empty pattern, are skipped when played. The pattern elements are decoded in next_morse_bit().
+static const char morse_table_first = ' ';
+static const char morse_table_last  = '_';
+static const char morse_table[morse_table_last - morse_table_first + 1][7] PROGMEM = {
+  " ",       // ' '
+  "---.",    // !
+  ".-..-.",  // "
+  "",        // #
+  "",        // $
+  "",        // %
+  ",...",    // &
+  ".----.",  // '
+  "-.--.-",  // (
+  "-.--.-",  // )
+  "",        // *
+  "",        // +
+  ".-.-",    // ,
+  "-....-",  // -
+  "..--..",  // .
+  "-..-.",   // /
+  "0",       // 0
+  ".--.",    // 1
+  "..-..",   // 2
+  "...-.",   // 3
+  "....-",   // 4
+  "---",     // 5
+  "......",  // 6
+  "--..",    // 7
+  "-....",   // 8
+  "-..-",    // 9
+  "---...",  // :
+  "-.-.-.",  // ;
+  "",        // <
+  "-...-",   // =
+  "",        // >
+  "-..-.",   // ?
+  ".--.-.",  // @
+  ".-",      // A
+  "-...",    // B
+  ".,.",     // C
+  "-..",     // D
+  ".",       // E
+  ".-.",     // F
+  "--.",     // G
+  "....",    // H
+  "..",      // I
+  "-.-.",    // J
+  "-.-",     // K
+  "L",       // L
+  "--",      // M
+  "-.",      // N
+  ",.",      // O
+  ".....",   // P
+  "..-.",    // Q
+  ",..",     // R
+  "...",     // S
+  "-",       // T
+  "..-",     // U
+  "...-",    // V
+  ".--",     // W
+  ".-..",    // X
+  ".,..",    // Y
+  "..,.",    // Z
+  "",        // [
+  "",        // backslash
+  "",        // ]
+  "",        // ^
+  "..__._",  // _
+};
 
 
 MorseBuzzer::MorseBuzzer()
 : state_(PLAYING_DONE),
   pin_(-1),
+  port_(NOT_A_PORT),
+  bit_mask_(0),
   active_hi_(true),
   text_(0),
+  text_progmem_(false),
+  stream_(0),
   morse_(0),
   verbosity_(0)
 {
-  initialize_morse_table();
 }
 
 MorseBuzzer::~MorseBuzzer()
@@ -107,24 +118,39 @@ MorseBuzzer::~MorseBuzzer()
 void
 MorseBuzzer::buzzer_off()
 {
-  if (pin_ != -1)
-    digitalWrite(pin_, active_hi_ ? LOW : HIGH);
+  if (pin_ != -1) {
+    buzzer_output_set(port_, bit_mask_, !active_hi_);
+    trace_buzzer(pin_, false);
+  }
 }
 
 void
 MorseBuzzer::buzzer_on()
 {
-  if (pin_ != -1)
-    digitalWrite(pin_, active_hi_ ? HIGH : LOW);
+  if (pin_ != -1) {
+    buzzer_output_set(port_, bit_mask_, active_hi_);
+    trace_buzzer(pin_, true);
+  }
 }
 
 void
-MorseBuzzer::setup(int pin, boolean active_hi)
+MorseBuzzer::setup(int pin, boolean active_hi, unsigned dot_time, unsigned char_space_time)
 {
+  // Work out the element lengths once here, rather than for every element we play
+  if (dot_time == 0)
+    dot_time = default_dot_time;
+  if (char_space_time == 0)
+    char_space_time = 3*dot_time;
+  dot_time_        = dot_time;
+  dash_time_       = 2*dot_time;
+  l_time_          = 4*dot_time;
+  zero_time_       = 5*dot_time;
+  char_space_time_ = char_space_time;
+  word_space_time_ = (4UL*char_space_time) / 3;   // 4 dots, stretched like the character space
+
   pin_  = pin;
   active_hi_ = active_hi;
-  pinMode(pin_, OUTPUT);
-  buzzer_off();
+  port_ = buzzer_output_setup(pin_, active_hi_ ? LOW : HIGH, &bit_mask_);
   buzzer_off();
 }
 
@@ -132,6 +158,32 @@ void
 MorseBuzzer::start(const char *text)
 {
   text_ = text;
+  text_progmem_ = false;
+  stream_ = 0;
+  morse_ = 0;
+  state_ = PLAYING_DONE;
+  next_char();
+}
+
+void
+MorseBuzzer::start(const __FlashStringHelper *text)
+{
+  // Play the text straight out of program memory, no copy into SRAM needed
+  text_ = reinterpret_cast<const char *>(text);
+  text_progmem_ = true;
+  stream_ = 0;
+  morse_ = 0;
+  state_ = PLAYING_DONE;
+  next_char();
+}
+
+void
+MorseBuzzer::start_stream(int (*source)())
+{
+  // Play text as it arrives. source() returns the next character, '\0' at the end of the
+  // message, or -1 if the next character hasn't arrived yet.
+  text_ = 0;
+  stream_ = source;
   morse_ = 0;
   state_ = PLAYING_DONE;
   next_char();
@@ -148,7 +200,19 @@ bool
 MorseBuzzer::next_char()
 {
   while (1) {
-    byte curr_char = (*text_++) & 0x7f;
+    int next;
+    if (stream_ != 0) {
+      next = (*stream_)();
+      if (next < 0) {
+        // The streamed text hasn't arrived yet; still_playing() will try again
+        state_ = PLAYING_WAIT;
+        return true;
+      }
+    } else {
+      next = text_progmem_ ? pgm_read_byte(text_) : *text_;
+      text_++;
+    }
+    byte curr_char = next & 0x7f;
     if (curr_char == '\0') {
       if (verbosity_ > 0) {
         DebugSerial_println("morse eom");
@@ -162,8 +226,10 @@ MorseBuzzer::next_char()
 
 
     // Now lookup the Morse pattern for the current character
-    morse_ = morse_table[curr_char];
-    if (morse_ == 0) {
+    if ((curr_char < morse_table_first) || (curr_char > morse_table_last))
+      continue;
+    morse_ = morse_table[curr_char - morse_table_first];
+    if (pgm_read_byte(morse_) == '\0') {
       // No morse patter to match this character, so skip to next
       continue;
     }
@@ -172,7 +238,7 @@ MorseBuzzer::next_char()
       DebugSerial_print("morse.next_char() '");
       DebugSerial_print(static_cast<char>(curr_char));
       DebugSerial_print("' -> ");
-      DebugSerial_println(morse_);
+      DebugSerial_println(reinterpret_cast<const __FlashStringHelper *>(morse_));
     }
 
     // Start the first bit of the new character
@@ -183,7 +249,7 @@ MorseBuzzer::next_char()
 bool
 MorseBuzzer::next_morse_bit()
 {
-  char morse_bit = *morse_++;
+  char morse_bit = pgm_read_byte(morse_++);
   switch (morse_bit) {
     case '\0':
       // End of current character
@@ -191,36 +257,38 @@ MorseBuzzer::next_morse_bit()
 
     case ' ':
       buzz_time_ = 0;
-      gap_time_  = 4*dot_time; // we will add 3 below
+      gap_time_  = word_space_time_; // we will add char_space_time_ below
       break;
     case '.':
-      buzz_time_ = dot_time;
-      gap_time_  = dot_time;
+      buzz_time_ = dot_time_;
+      gap_time_  = dot_time_;
       break;
     case ',':  // i.e. "dot space"
-      buzz_time_ = dot_time;
-      gap_time_  = 2*dot_time;
+      buzz_time_ = dot_time_;
+      gap_time_  = dash_time_;
       break;
     case '-':
-      buzz_time_ = 2*dot_time;
-      gap_time_  = dot_time;
+      buzz_time_ = dash_time_;
+      gap_time_  = dot_time_;
       break;
     case 'L':
-      buzz_time_ = 4*dot_time;
-      gap_time_  = dot_time;
+      buzz_time_ = l_time_;
+      gap_time_  = dot_time_;
       break;
     case '0':
-      buzz_time_ = 5*dot_time;
-      gap_time_  = dot_time;
+      buzz_time_ = zero_time_;
+      gap_time_  = dot_time_;
       break;
   }
 
   // If this is the last morse bit of this character (next bit is nul), add the inter-character gap to the off_time
-  if (*morse_ == '\0')
-    gap_time_ += 3*dot_time;
+  if (pgm_read_byte(morse_) == '\0')
+    gap_time_ += char_space_time_;
 
-  if (buzz_time_ > 0)
+  if (buzz_time_ > 0) {
     buzzer_on();
+    sounder_click(true);
+  }
   state_ = PLAYING_BUZZ;
   ref_millis_ = millis();
   if (verbosity_ > 1) {
@@ -240,6 +308,9 @@ MorseBuzzer::still_playing()
     return false;
   }
 
+  if (state_ == PLAYING_WAIT)
+    return next_char();
+
   // Compute time elapsed since our "ref_millis"
   unsigned elapsed = millis() - ref_millis_;
 
@@ -247,7 +318,10 @@ MorseBuzzer::still_playing()
     // We are playing the buzz, is it time to turn off?
     if (elapsed >= buzz_time_) {
       // Time to turn off
+      profile_morse_edge(elapsed - buzz_time_);
       buzzer_off();
+      if (buzz_time_ > 0)
+        sounder_click(false);
       state_ = PLAYING_GAP;
       ref_millis_ = millis();
       if (verbosity_ > 1) {
@@ -264,5 +338,6 @@ MorseBuzzer::still_playing()
     return true;
 
   // Time to move to next bit
+  profile_morse_edge(elapsed - gap_time_);
   return next_morse_bit();
 }
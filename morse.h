@@ -22,10 +22,16 @@ class MorseBuzzer {
 public:
   MorseBuzzer();
   ~MorseBuzzer();
-  void setup( int pin, boolean active_hi );
+  // dot_time and char_space_time are in msec; 0 gives the default 100 msec dot and a standard
+  // 3 dot space between characters. A longer char_space_time gives Farnsworth spacing.
+  void setup( int pin, boolean active_hi, unsigned dot_time = 0, unsigned char_space_time = 0 );
   void start( const char *text );
+  void start( const __FlashStringHelper *text );   // text in PROGMEM
+  void start_stream( int (*source)() );            // text arriving while we play
   void cancel();
   bool still_playing();
+  unsigned dot_time() { return dot_time_; }
+  unsigned char_space_time() { return char_space_time_; }
 
 private:
   void buzzer_off();
@@ -36,16 +42,29 @@ private:
   enum {
     PLAYING_DONE,
     PLAYING_BUZZ,
-    PLAYING_GAP
+    PLAYING_GAP,
+    PLAYING_WAIT    // waiting for more streamed text
   } state_;
   int  pin_;
+  uint8_t port_;          // see buzzer_output.h
+  uint8_t bit_mask_;
   boolean active_hi_;
   const char *text_;
-  const char *morse_;
+  bool text_progmem_;
+  int (*stream_)();
+  const char *morse_;     // points into the PROGMEM morse_table
 
   unsigned long ref_millis_;
   unsigned buzz_time_;
   unsigned gap_time_;
+
+  // Element lengths in msec, worked out in setup()
+  unsigned dot_time_;
+  unsigned dash_time_;
+  unsigned l_time_;
+  unsigned zero_time_;
+  unsigned char_space_time_;   // added after the last element of each character
+  unsigned word_space_time_;
   unsigned verbosity_;
 };
 
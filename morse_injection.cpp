@@ -0,0 +1,127 @@
+// morse_injection.cpp -- play Morse text typed into the serial port on a station buzzer
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+#include "morse_injection.h"
+#include "station_info.h"
+#include "DebugSerial.h"
+
+#ifdef WANT_MORSE_INJECTION
+
+#ifndef WANT_REAL_SERIAL
+#error "WANT_MORSE_INJECTION reads the serial port; enable WANT_REAL_SERIAL in DebugSerial.h"
+#endif
+
+static const char XON  = 0x11;
+static const char XOFF = 0x13;
+
+// The ring buffer. ring_head and ring_tail count up forever (wrapping at 256), so that
+// ring_head - ring_tail is the number of characters waiting. ring_size must be a power of two.
+static const uint8_t ring_size = 32;
+static const uint8_t ring_mask = ring_size - 1;
+static char          ring[ring_size];
+static uint8_t       ring_head = 0;
+static uint8_t       ring_tail = 0;
+
+// XOFF goes out when no more than xoff_free places are left, leaving room for the characters
+// already on the wire, and XON once xon_free places are free again.
+static const uint8_t xoff_free = 8;
+static const uint8_t xon_free  = 16;
+static bool          xoff_sent = false;
+
+static const unsigned injection_timeout_msec = 5000;
+
+static bool          line_open = false;
+static unsigned long last_byte_millis;
+
+static inline uint8_t
+ring_count()
+{
+  return ring_head - ring_tail;
+}
+
+// The first ambience station plays the injected text; without one the text is thrown away
+static const Station_Info *
+injection_station()
+{
+  for (int ii = 0; ii < num_stations; ii++) {
+    if (stations[ii].station_type_ == STATION_AMBIENCE)
+      return &stations[ii];
+  }
+  return 0;
+}
+
+bool
+morse_injection_receiving()
+{
+  return line_open;
+}
+
+bool
+morse_injection_receive(char c)
+{
+  last_byte_millis = millis();
+  if (!line_open) {
+    // This is the '>' that starts the line
+    line_open = true;
+    return true;
+  }
+
+  if (ring_count() == ring_size)
+    return false;
+
+  if ((c == '\r') || (c == '\n')) {
+    c = '\0';
+    line_open = false;
+  } else if (('a' <= c) && (c <= 'z')) {
+    c -= 'a' - 'A';
+  }
+  if (injection_station() == 0)
+    return true;
+
+  ring[ring_head++ & ring_mask] = c;
+  if (!xoff_sent && (ring_size - ring_count() <= xoff_free)) {
+    Serial.write(XOFF);
+    xoff_sent = true;
+  }
+  return true;
+}
+
+bool
+morse_injection_pending(const Station_Info *station)
+{
+  return (station == injection_station()) && (line_open || (ring_count() != 0));
+}
+
+int
+morse_injection_next_char()
+{
+  if (ring_count() == 0) {
+    if (line_open && (millis() - last_byte_millis < injection_timeout_msec))
+      return -1;
+
+    // The sender has gone quiet in the middle of a line, so end the message here
+    line_open = false;
+    return '\0';
+  }
+
+  const char c = ring[ring_tail++ & ring_mask];
+  if (xoff_sent && (ring_size - ring_count() >= xon_free)) {
+    Serial.write(XON);
+    xoff_sent = false;
+  }
+  return c;
+}
+
+#endif
@@ -0,0 +1,60 @@
+// morse_injection.h -- play Morse text typed into the serial port on a station buzzer
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+#ifndef INCLUDED_morse_injection
+#define INCLUDED_morse_injection
+
+#include <Arduino.h>
+
+struct Station_Info;
+
+// With WANT_MORSE_INJECTION enabled (the #define line below is the *last* of the pair), a line
+// sent to the serial port starting with '>' is played on the first ambience station in the
+// stations table, e.g.
+//
+//   >OS NO 2 BY ND AT 1445
+//
+// The text is played as it arrives through a small ring buffer, so lines of any length can be
+// sent. The sketch sends XOFF when the buffer is nearly full and XON once it has drained, so
+// the sending terminal must have XON/XOFF flow control turned on. The message waits its turn
+// like any other ring, and a line that stops arriving for injection_timeout_msec is ended.
+#define WANT_MORSE_INJECTION
+#undef WANT_MORSE_INJECTION
+
+#ifdef WANT_MORSE_INJECTION
+
+// True while the bytes arriving on the serial port belong to a '>' line
+bool morse_injection_receiving();
+
+// Offer the next serial byte (the '>' itself, or one inside the line). Returns false if the
+// buffer is full, in which case the byte must be left unread and offered again later.
+bool morse_injection_receive(char c);
+
+// True if station has injected text waiting to be played (or partly played)
+bool morse_injection_pending(const Station_Info *station);
+
+// Text source for MorseBuzzer::start_stream()
+int morse_injection_next_char();
+
+#else
+
+inline bool morse_injection_receiving() { return false; }
+inline bool morse_injection_receive(char c) { return true; }
+inline bool morse_injection_pending(const Station_Info *station) { return false; }
+inline int morse_injection_next_char() { return '\0'; }
+
+#endif
+
+#endif
@@ -0,0 +1,122 @@
+// profile.cpp -- optional timing measurements for station_buzzers
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+#include "profile.h"
+#include "station_info.h"
+#include "memory_stats.h"
+#include "DebugSerial.h"
+#include <avr/pgmspace.h>
+
+#ifdef WANT_PROFILE
+
+#ifndef WANT_REAL_SERIAL
+#error "WANT_PROFILE reports over the serial port; enable WANT_REAL_SERIAL in DebugSerial.h"
+#endif
+
+static const unsigned long profile_report_msec = 10000;
+
+// From the linker script: the end of .data's initial values, the last thing in the flash image
+extern const char __data_load_end[];
+
+static unsigned long tick_start_micros;
+static unsigned long tick_count;
+static unsigned long tick_total_micros;
+static unsigned long tick_max_micros;
+static unsigned      edge_late_max_msec;
+static unsigned long report_millis;
+
+// The previous period's figures, waiting to be printed. report_field is the next field of the
+// line to write, or 0 once it is all written; each field is written only when the transmit
+// buffer has room for the longest one, so a print never waits for the UART.
+static const int     report_field_max_chars = 32;
+static uint8_t       report_field = 0;
+static unsigned long report_ticks;
+static unsigned long report_tick_avg_micros;
+static unsigned long report_tick_max_micros;
+static unsigned      report_edge_late_max_msec;
+
+static void
+print_report()
+{
+  while ((report_field != 0) && (Serial.availableForWrite() >= report_field_max_chars)) {
+    switch (report_field++) {
+      case 1: Serial.print(F("PROFILE table="));     Serial.print(station_table_name); break;
+      case 2: Serial.print(F(" ticks="));            Serial.print(report_ticks); break;
+      case 3: Serial.print(F(" tick_avg_us="));      Serial.print(report_tick_avg_micros); break;
+      case 4: Serial.print(F(" tick_max_us="));      Serial.print(report_tick_max_micros); break;
+      case 5: Serial.print(F(" edge_late_max_ms="));  Serial.print(report_edge_late_max_msec); break;
+#ifdef WANT_MEMORY_STATS
+      case 6: Serial.print(F(" flash_bytes="));       Serial.print(pgm_get_far_address(__data_load_end)); break;
+      default:
+        Serial.print(F(" sram_free_min="));          Serial.println(memory_free_min_bytes());
+        report_field = 0;
+        break;
+#else
+      default:
+        Serial.print(F(" flash_bytes="));            Serial.println(pgm_get_far_address(__data_load_end));
+        report_field = 0;
+        break;
+#endif
+    }
+  }
+}
+
+void
+profile_tick_begin()
+{
+  tick_start_micros = micros();
+}
+
+void
+profile_tick_end()
+{
+  const unsigned long tick_micros = micros() - tick_start_micros;
+  tick_count++;
+  tick_total_micros += tick_micros;
+  if (tick_micros > tick_max_micros)
+    tick_max_micros = tick_micros;
+
+  // The report is printed outside of the timed region, so it doesn't count against the tick
+  print_report();
+
+  const unsigned long now_millis = millis();
+  if (now_millis - report_millis < profile_report_msec)
+    return;
+
+  // If the port is so busy that the last report is still going out, this period runs on
+  if (report_field != 0)
+    return;
+  report_ticks = tick_count;
+  report_tick_avg_micros = tick_total_micros / tick_count;
+  report_tick_max_micros = tick_max_micros;
+  report_edge_late_max_msec = edge_late_max_msec;
+  report_field = 1;
+  print_report();
+
+  tick_count = 0;
+  tick_total_micros = 0;
+  tick_max_micros = 0;
+  edge_late_max_msec = 0;
+  report_millis = now_millis;
+}
+
+void
+profile_morse_edge(unsigned late_msec)
+{
+  if (late_msec > edge_late_max_msec)
+    edge_late_max_msec = late_msec;
+}
+
+#endif
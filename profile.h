@@ -0,0 +1,60 @@
+// profile.h -- optional timing measurements for station_buzzers
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+#ifndef INCLUDED_profile
+#define INCLUDED_profile
+
+#include <Arduino.h>
+
+// With WANT_PROFILE enabled (the #define line below is the *last* of the pair), the sketch times
+// every pass through run_station_states() and every Morse element edge, and every
+// profile_report_msec prints one line of key=value pairs to the serial port, e.g.
+//
+//   PROFILE table=DAVID_PARKS ticks=41230 tick_avg_us=236 tick_max_us=612 edge_late_max_ms=1 flash_bytes=21484 sram_free_min=1102
+//
+// "edge_late_max_ms" is how much later than scheduled the worst buzzer edge was switched. The
+// tick times come from micros(), so they have its 4 microsecond resolution. "flash_bytes" is
+// the size of the program image, and "sram_free_min" the least free SRAM ever seen between the
+// heap and the stack (only with WANT_MEMORY_STATS, see memory_stats.h). The figures other than
+// those two cover the period since the previous report, so a log captured while exercising a
+// board with each of the station tables can be compared against earlier runs.
+//
+// Profiling needs WANT_REAL_SERIAL, and turns the debug messages off (see DebugSerial.h) so
+// that the ticks measure the state machine rather than the UART. The report itself is written
+// a field at a time, only as room appears in the serial transmit buffer, so it never holds up
+// loop() either.
+//
+// host/profile_report runs this code in the host simulation, where time only passes between
+// loop() passes or while a serial write waits for room. It can only ever show tick_max_us=0
+// (and flash_bytes=0), so it checks that the report never blocks, not how fast the sketch is;
+// real figures come only from a board.
+#define WANT_PROFILE
+#undef WANT_PROFILE
+
+#ifdef WANT_PROFILE
+
+void profile_tick_begin();
+void profile_tick_end();
+void profile_morse_edge(unsigned late_msec);
+
+#else
+
+inline void profile_tick_begin() { }
+inline void profile_tick_end() { }
+inline void profile_morse_edge(unsigned late_msec) { }
+
+#endif
+
+#endif
@@ -0,0 +1,388 @@
+// ring_bus.cpp -- token passing between station_buzzers boards sharing a serial bus
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+#include "ring_bus.h"
+#include "DebugSerial.h"
+#include "station_info.h"
+
+#ifdef WANT_RING_BUS
+
+// The protocol
+// ============
+//
+// Every message on the bus is a six byte frame:
+//
+//     0xA5, type, source node, destination node, token sequence, ~(type + source + dest + seq)
+//
+// The node holding the token may start one ring with it. Once that ring has finished and the
+// usual silence interval has passed (or right away if it has nothing waiting), it sends a TOKEN
+// frame to the next node id, which must answer with an ACK. A node that does not ACK is tried
+// once more and then skipped, so a board that has been switched off or has lost its bus
+// connection simply drops out of the rotation.
+//
+// Each hand-off gives the token the next sequence number, and every frame carries the number
+// of the token its sender holds (or is handing over, or is acknowledging). That is what keeps a
+// lost ACK from turning into two tokens: the sender skips ahead to the node after, but the
+// skipped node hears that TOKEN go by with a newer number than its own and drops its copy. A
+// TOKEN repeated because its ACK was lost carries the number already accepted and is only
+// ACKed again, so it can't hand the receiver a second ring. In general, a node holding a token
+// that hears another node claim one compares numbers: the newer token wins (the lower node id
+// on a tie), the loser drops its token and abandons any ring it started with it, and the winner
+// sends a HOLD straight away in case the loser missed the frame that settled it.
+//
+// Before ringing, the holder sends a HOLD as a claim and waits claim_msec, longer than a lost
+// ACK takes to be noticed, so any duplicate made by a lost ACK is settled before a buzzer
+// sounds. While it holds the token a node also sends a HOLD frame every hold_interval_msec,
+// so that a long ambience message doesn't look like a dead bus. If the bus is silent for
+// regen_timeout_msec the token is assumed lost with its holder, and the lowest-numbered
+// surviving node makes a new one numbered after the last one heard (each node waits an extra
+// regen_slot_msec per node id, so node 0 goes first).
+//
+// With the token idling around the bus, a board waits at most
+//     num_nodes * (token_idle_hold_msec + 2 frame times) + claim_msec
+// before it may ring, about 150 msec for four boards at 38400 baud, and the bus is busy for
+// about 3 msec of every 23 msec.
+//
+// Note that on a board without a second hardware serial port (an Uno, Nano or Pro Mini) the
+// bus takes over Serial, and so pins 0 and 1; no station may use them (see ring_bus.h).
+
+#if defined(HAVE_HWSERIAL1)
+// Leonardo, Mega, etc -- "Serial" is the USB port or is left for debugging
+#define RingBusSerial Serial1
+#else
+#if defined(WANT_REAL_SERIAL) || defined(WANT_VCD_TRACE)
+#error "The ring bus needs the only hardware serial port; disable WANT_REAL_SERIAL and WANT_VCD_TRACE in DebugSerial.h"
+#endif
+#define RingBusSerial Serial
+#define RING_BUS_ON_PINS_0_1
+#endif
+
+static const unsigned long ring_bus_baud = 38400;
+
+static const byte frame_sync = 0xA5;
+static const byte frame_length = 6;
+
+enum Frame_Type {
+  FRAME_TOKEN = 1,  // the token is handed to the destination node
+  FRAME_ACK   = 2,  // the destination node has accepted the token
+  FRAME_HOLD  = 3   // keep-alive (or claim before ringing) from the current token holder
+};
+
+static const unsigned token_idle_hold_msec = 20;   // an unused token stays at least this long
+static const unsigned ack_timeout_msec     = 20;   // time allowed for the next node to ACK
+static const unsigned hold_interval_msec   = 500;  // keep-alive period while holding the token
+static const unsigned regen_timeout_msec   = 2000; // silent bus means the token was lost
+static const unsigned regen_slot_msec      = 100;  // extra wait per node id before regenerating
+
+// A lost ACK is noticed (and the token handed past its receiver) two ACK timeouts after the
+// first TOKEN, so a claim outlasts that with some room for the frame and a slow loop() pass.
+static const unsigned claim_msec = 3 * ack_timeout_msec;
+
+// Token state for this node
+static bool          have_token = false;
+static bool          token_used = false;       // a ring has been started with this token
+static bool          token_released = false;   // we have nothing (more) to ring
+static unsigned long token_millis;             // when we received the token
+static unsigned long hold_sent_millis;         // when we last sent FRAME_HOLD
+static uint8_t       token_seq;                // sequence number of our token (or the one being passed)
+static bool          token_claimed = false;    // we have sent the HOLD claiming it for a ring
+static unsigned long claim_millis;             // when we sent that HOLD
+
+// Sequence numbers seen on the bus
+static uint8_t       last_seq;                 // the newest heard, for a regenerated token
+static uint8_t       accepted_seq;             // the last TOKEN accepted, to spot a repeat
+static unsigned long accepted_millis;
+
+// Token hand-off in progress
+static bool          passing = false;
+static uint8_t       pass_to;
+static uint8_t       pass_tries;
+static unsigned long pass_millis;
+
+// False if the station table leaves the bus no pins; the board then rings on its own
+static bool          bus_started = false;
+
+// Receiver state; rx_count is rx_hunting while we are looking for the sync byte
+static const uint8_t rx_hunting = 0xff;
+static byte          rx_frame[frame_length - 1];
+static uint8_t       rx_count = rx_hunting;
+static unsigned long bus_activity_millis;
+
+static inline uint8_t
+next_node(uint8_t node)
+{
+  return (node + 1 < ring_bus_num_nodes) ? node + 1 : 0;
+}
+
+// Sequence numbers wrap, so "newer" means less than half way round ahead
+static inline bool
+seq_newer(uint8_t a, uint8_t b)
+{
+  return static_cast<int8_t>(a - b) > 0;
+}
+
+static void
+send_frame(byte type, byte dst, byte seq)
+{
+  const byte frame[frame_length] = {
+    frame_sync, type, ring_bus_node_id, dst, seq,
+    static_cast<byte>(~(type + ring_bus_node_id + dst + seq))
+  };
+
+  if (ring_bus_tx_enable_pin != -1)
+    digitalWrite(ring_bus_tx_enable_pin, HIGH);
+  RingBusSerial.write(frame, frame_length);
+  if (ring_bus_tx_enable_pin != -1) {
+    // Hold the RS-485 driver on until the last stop bit has gone out
+    RingBusSerial.flush();
+    digitalWrite(ring_bus_tx_enable_pin, LOW);
+  }
+}
+
+static void
+accept_token(uint8_t seq)
+{
+  have_token = true;
+  token_used = false;
+  token_released = false;
+  token_claimed = false;
+  token_seq = seq;
+  if (seq_newer(seq, last_seq))
+    last_seq = seq;
+  token_millis = hold_sent_millis = millis();
+}
+
+static void
+pass_token(uint8_t dst)
+{
+  have_token = false;
+  if (dst == ring_bus_node_id) {
+    // Everyone else is gone, so the token comes straight back to us
+    passing = false;
+    accept_token(token_seq + 1);
+    return;
+  }
+  passing = true;
+  pass_to = dst;
+  pass_tries = 0;
+  pass_millis = millis();
+  token_seq++;
+  if (seq_newer(token_seq, last_seq))
+    last_seq = token_seq;
+  send_frame(FRAME_TOKEN, dst, token_seq);
+}
+
+static void
+send_hold()
+{
+  hold_sent_millis = millis();
+  send_frame(FRAME_HOLD, ring_bus_node_id, token_seq);
+}
+
+// A TOKEN addressed to us
+static void
+token_offered(uint8_t seq)
+{
+  const unsigned long now_millis = millis();
+
+  // The sender missed our ACK and is repeating itself; we may have passed the token on since
+  if ((seq == accepted_seq) && (now_millis - accepted_millis < claim_msec))
+    return;
+  accepted_seq = seq;
+  accepted_millis = now_millis;
+
+  if (have_token) {
+    // A second token: fold it into ours, keeping the one ring this visit is allowed
+    DebugSerial_println(F("ring bus: duplicate token merged"));
+    if (seq_newer(seq, token_seq))
+      token_seq = seq;
+    return;
+  }
+  passing = false;
+  accept_token(seq);
+}
+
+// Another node claims the token numbered seq for owner while we hold or are passing ours
+static void
+token_conflict(uint8_t seq, uint8_t owner)
+{
+  const uint8_t our_owner = have_token ? ring_bus_node_id : pass_to;
+  if (seq_newer(seq, token_seq) || ((seq == token_seq) && (owner < our_owner))) {
+    DebugSerial_println(F("ring bus: duplicate token dropped"));
+    have_token = false;
+    passing = false;
+  } else if (have_token) {
+    send_hold();
+  }
+}
+
+static void
+frame_received(byte type, byte src, byte dst, byte seq)
+{
+  bus_activity_millis = millis();
+  if (seq_newer(seq, last_seq))
+    last_seq = seq;
+
+  // With a half-duplex transceiver we hear our own frames as well
+  if (src == ring_bus_node_id)
+    return;
+
+  if ((type == FRAME_TOKEN) && (dst == ring_bus_node_id)) {
+    send_frame(FRAME_ACK, src, seq);
+    token_offered(seq);
+    return;
+  }
+
+  // The ACK, or anything else the new holder sends with our token, completes a hand-off
+  if (passing && (src == pass_to) && (seq == token_seq)) {
+    passing = false;
+    return;
+  }
+
+  // Anything else means someone else thinks they hold a token: the destination of a TOKEN, the
+  // sender of an ACK or HOLD
+  if (have_token || passing)
+    token_conflict(seq, (type == FRAME_TOKEN) ? dst : src);
+}
+
+static void
+receive_byte(byte b)
+{
+  if (rx_count == rx_hunting) {
+    if (b == frame_sync)
+      rx_count = 0;
+    return;
+  }
+
+  rx_frame[rx_count++] = b;
+  if (rx_count < sizeof(rx_frame))
+    return;
+
+  // A frame with a bad check byte is dropped and we go back to hunting for the sync byte
+  rx_count = rx_hunting;
+  if (static_cast<byte>(~(rx_frame[0] + rx_frame[1] + rx_frame[2] + rx_frame[3])) == rx_frame[4])
+    frame_received(rx_frame[0], rx_frame[1], rx_frame[2], rx_frame[3]);
+}
+
+void
+init_ring_bus()
+{
+#ifdef RING_BUS_ON_PINS_0_1
+  // RingBusSerial.begin() would make pins 0 and 1 the UART's RX and TX, reading a hook switch
+  // there as bus traffic and driving a buzzer there with it
+  for (int ii = 0; ii < num_stations; ii++) {
+    Station_Info * const station = &stations[ii];
+    if ((station->buzzer_pin_ <= 1) || (station->called_pin_ <= 1) || (station->off_hook_pin_ <= 1)) {
+      DebugSerial_print(F("ring bus: station ")); DebugSerial_print(station->station_code());
+      DebugSerial_println(F(" uses pin 0 or 1, bus not started"));
+      return;
+    }
+  }
+#endif
+  bus_started = true;
+  if (ring_bus_tx_enable_pin != -1) {
+    pinMode(ring_bus_tx_enable_pin, OUTPUT);
+    digitalWrite(ring_bus_tx_enable_pin, LOW);
+  }
+  RingBusSerial.begin(ring_bus_baud);
+  bus_activity_millis = millis();
+}
+
+void
+run_ring_bus()
+{
+  if (!bus_started)
+    return;
+
+  while (RingBusSerial.available() > 0)
+    receive_byte(RingBusSerial.read());
+
+  const unsigned long now_millis = millis();
+
+  if (passing) {
+    if (now_millis - pass_millis < ack_timeout_msec)
+      return;
+    if (++pass_tries < 2) {
+      pass_millis = now_millis;
+      send_frame(FRAME_TOKEN, pass_to, token_seq);
+    } else {
+      DebugSerial_print(F("ring bus: node ")); DebugSerial_print(pass_to);
+      DebugSerial_println(F(" skipped"));
+      pass_token(next_node(pass_to));
+    }
+    return;
+  }
+
+  if (have_token) {
+    if (token_released && (token_used || (now_millis - token_millis >= token_idle_hold_msec))) {
+      pass_token(next_node(ring_bus_node_id));
+    } else if (now_millis - hold_sent_millis >= hold_interval_msec) {
+      send_hold();
+    }
+    return;
+  }
+
+  // Nobody has been heard from for too long, so the token died with its holder
+  const unsigned long regen_msec = regen_timeout_msec + ring_bus_node_id * regen_slot_msec;
+  if (now_millis - bus_activity_millis >= regen_msec) {
+    DebugSerial_println(F("ring bus: token regenerated"));
+    accept_token(last_seq + 1);
+    bus_activity_millis = now_millis;
+    send_hold();
+  }
+}
+
+bool
+ring_bus_may_ring()
+{
+  if (!bus_started)
+    return true;
+  if (!have_token)
+    return false;
+  if (token_used) {
+    // One ring per visit of the token
+    token_released = true;
+    return false;
+  }
+  if (!token_claimed) {
+    token_claimed = true;
+    claim_millis = millis();
+    send_hold();
+    return false;
+  }
+  return millis() - claim_millis >= claim_msec;
+}
+
+bool
+ring_bus_holding()
+{
+  return have_token || !bus_started;
+}
+
+void
+ring_bus_token_used()
+{
+  token_used = true;
+  token_released = false;
+}
+
+void
+ring_bus_release_token()
+{
+  if (have_token)
+    token_released = true;
+}
+
+#endif
@@ -0,0 +1,73 @@
+// ring_bus.h -- layout-wide ring arbitration between several station_buzzers boards
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+#ifndef INCLUDED_ring_bus
+#define INCLUDED_ring_bus
+
+#include <Arduino.h>
+
+// Each board keeps only one of its own stations ringing at a time (see current_ringer in
+// station_states.cpp), but on a layout with several boards two buzzers could still sound at
+// once. With WANT_RING_BUS enabled the boards pass a single "ring token" around a shared
+// serial bus (RS-485 or a wired-OR UART), and only the board holding the token may start a
+// ring.  Enable it by making the #define line below the *last* of the pair.
+//
+// The bus uses Serial1 on boards that have one (Leonardo, Micro, Mega). On a board with only
+// the one hardware serial port (Uno, Nano, Pro Mini) it takes over Serial, and with it pins 0
+// and 1, so no station on such a board may be wired to those pins; MRCS_REV2 uses them for
+// the AA and BB hook switches and so can't join a bus. On such a board init_ring_bus() leaves
+// the bus alone if the station table uses pin 0 or 1, and the board rings as if it were alone.
+#define WANT_RING_BUS
+#undef WANT_RING_BUS
+
+#ifdef WANT_RING_BUS
+
+// These are defined next to the station table in station_buzzers.ino. Node ids run from 0 to
+// ring_bus_num_nodes-1 and must be unique on the bus.
+extern const uint8_t ring_bus_node_id;
+extern const uint8_t ring_bus_num_nodes;
+extern const int8_t  ring_bus_tx_enable_pin;   // RS-485 driver enable, or -1 for none
+
+void init_ring_bus();
+void run_ring_bus();
+
+// True when this board holds the token, has not yet started a ring with it, and has claimed
+// it on the bus long enough ago that no other board can also be holding one. Call it only when
+// there is a station waiting to ring: the first call sends the claim, and while the token has
+// already been used it releases the token instead.
+bool ring_bus_may_ring();
+
+// True while this board still holds the token. A ring started with a token that turns out to
+// have a duplicate elsewhere on the bus is abandoned when this goes false.
+bool ring_bus_holding();
+
+// Called when a ring is started with the token; the token is passed on once it is released.
+void ring_bus_token_used();
+
+// Called when this board has nothing (more) to ring; the token moves on to the next board.
+void ring_bus_release_token();
+
+#else
+
+inline void init_ring_bus() { }
+inline void run_ring_bus() { }
+inline bool ring_bus_may_ring() { return true; }
+inline bool ring_bus_holding() { return true; }
+inline void ring_bus_token_used() { }
+inline void ring_bus_release_token() { }
+
+#endif
+
+#endif
@@ -0,0 +1,193 @@
+// sounder.cpp -- plays telegraph sounder clicks along with the Morse code
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+#include "sounder.h"
+#include "station_info.h"
+#include "DebugSerial.h"
+
+#ifdef WANT_SOUNDER
+
+#if !defined(TCCR2A)
+#error "WANT_SOUNDER needs Timer2, which this processor doesn't have"
+#endif
+
+#include "sounder_samples.h"
+
+// Timer2 runs in phase-correct PWM mode from the undivided clock, a 31.4 kHz carrier well above
+// hearing, with the sample level in OCR2B. The overflow interrupt fires once per PWM period, and
+// every pwm_periods_per_sample of them it moves the next level into OCR2B, giving 7.8 kHz.
+//
+// The handler has to run 31,400 times a second while a click plays, and avr-gcc saves every
+// register a handler uses on every entry, so it is kept down to counting and popping a byte
+// from sample_buffer. The ADPCM decoding is done by run_sounder() from loop(), which keeps the
+// buffer topped up. sample_buffer holds 4 msec of sound, several passes through loop() (the
+// tasks are held to a 1 msec window, see tasks.cpp); if loop() falls behind anyway, say behind
+// a blocking debug print, the output holds its level until the buffer catches up.
+#if defined(__AVR_ATmega2560__) || defined(__AVR_ATmega1280__)
+static const uint8_t sounder_pin = 9;   // OC2B on a Mega
+#else
+static const uint8_t sounder_pin = 3;   // OC2B on a 328P
+#endif
+static const uint8_t pwm_periods_per_sample = 4;
+static const uint8_t pwm_silence = 128;
+
+static const int8_t adpcm_index_table[8] = { -1, -1, -1, -1, 2, 4, 6, 8 };
+
+// Decoded levels on their way to the interrupt handler. buffer_in is only written by
+// run_sounder() and buffer_out only by the handler, and each is a single byte, so neither side
+// needs to lock the other out. Both run freely and wrap; the difference is the fill.
+static const uint8_t           sample_buffer_size = 32;   // a power of two
+static uint8_t                 sample_buffer[sample_buffer_size];
+static volatile uint8_t        buffer_in;
+static volatile uint8_t        buffer_out;
+static volatile bool           decoding_done = true;      // nothing left to put in the buffer
+static uint8_t                 pwm_periods;
+
+// Decoder state, used only from loop()
+static bool                    sounder_started = false;
+static const uint8_t          *sample_data;
+static uint16_t                samples_left = 0;
+static bool                    high_nibble;
+static int16_t                 predictor;
+static uint8_t                 step_index;
+
+ISR(TIMER2_OVF_vect)
+{
+  if (--pwm_periods != 0)
+    return;
+  pwm_periods = pwm_periods_per_sample;
+
+  const uint8_t out = buffer_out;
+  if (out != buffer_in) {
+    OCR2B = sample_buffer[out & (sample_buffer_size - 1)];
+    buffer_out = out + 1;
+  } else if (decoding_done) {
+    // End of the click; park the output at the midpoint and stop interrupting
+    OCR2B = pwm_silence;
+    TIMSK2 &= ~_BV(TOIE2);
+  }
+}
+
+// Decode the next 4-bit IMA ADPCM code, low nibble first, into a PWM level
+static uint8_t
+decode_sample()
+{
+  uint8_t code = pgm_read_byte(sample_data);
+  if (high_nibble) {
+    code >>= 4;
+    sample_data++;
+  } else {
+    code &= 0x0f;
+  }
+  high_nibble = !high_nibble;
+
+  const uint16_t step = pgm_read_word(&adpcm_step_table[step_index]);
+  uint16_t diff = step >> 3;
+  if (code & 4)
+    diff += step;
+  if (code & 2)
+    diff += step >> 1;
+  if (code & 1)
+    diff += step >> 2;
+
+  int32_t next = (code & 8) ? (int32_t)predictor - diff : (int32_t)predictor + diff;
+  if (next > 32767)
+    next = 32767;
+  else if (next < -32768)
+    next = -32768;
+  predictor = next;
+
+  int8_t index = step_index + adpcm_index_table[code & 7];
+  step_index = (index < 0) ? 0 : ((index > 88) ? 88 : index);
+
+  return (predictor >> 8) + 128;
+}
+
+void
+run_sounder()
+{
+  if (decoding_done)
+    return;
+
+  uint8_t in = buffer_in;
+  while ((samples_left != 0) && (static_cast<uint8_t>(in - buffer_out) < sample_buffer_size)) {
+    sample_buffer[in & (sample_buffer_size - 1)] = decode_sample();
+    samples_left--;
+    buffer_in = ++in;
+  }
+  if (samples_left == 0)
+    decoding_done = true;
+}
+
+void
+init_sounder()
+{
+  // OC2B is wired to sounder_pin inside the chip. Driving PWM into a station's input, or having
+  // buzzer_output_setup() or enter_idle() take the pin back (which disconnects OC2B), would
+  // break both, so the sounder stays silent unless the stations leave the pin alone.
+  for (int ii = 0; ii < num_stations; ii++) {
+    Station_Info * const station = &stations[ii];
+    if ((station->buzzer_pin_ == sounder_pin) || (station->called_pin_ == sounder_pin) ||
+        (station->off_hook_pin_ == sounder_pin)) {
+      DebugSerial_print(F("sounder: pin ")); DebugSerial_print(sounder_pin);
+      DebugSerial_print(F(" is used by station ")); DebugSerial_print(station->station_code());
+      DebugSerial_println(F(", sounder disabled"));
+      return;
+    }
+  }
+  sounder_started = true;
+
+  pinMode(sounder_pin, OUTPUT);
+
+  const uint8_t old_sreg = SREG;
+  cli();
+  TCCR2A = _BV(COM2B1) | _BV(WGM20);   // phase-correct PWM, non-inverted output on OC2B
+  TCCR2B = _BV(CS20);                  // no prescaling
+  OCR2B = pwm_silence;
+  TIMSK2 &= ~_BV(TOIE2);
+  SREG = old_sreg;
+}
+
+void
+sounder_click(bool down)
+{
+  if (!sounder_started)
+    return;
+
+  // A new click simply cuts off whatever is still playing. Stop the handler, empty the buffer
+  // and fill it from the new click before starting the handler again, so the first sample
+  // goes out on time.
+  uint8_t old_sreg = SREG;
+  cli();
+  TIMSK2 &= ~_BV(TOIE2);
+  buffer_in = buffer_out;
+  decoding_done = false;
+  SREG = old_sreg;
+
+  sample_data  = down ? sounder_down_adpcm : sounder_up_adpcm;
+  samples_left = down ? sounder_down_samples : sounder_up_samples;
+  high_nibble  = false;
+  predictor    = 0;
+  step_index   = down ? sounder_down_start_index : sounder_up_start_index;
+  run_sounder();
+
+  old_sreg = SREG;
+  cli();
+  pwm_periods = pwm_periods_per_sample;
+  TIMSK2 |= _BV(TOIE2);
+  SREG = old_sreg;
+}
+
+#endif
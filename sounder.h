@@ -0,0 +1,53 @@
+// sounder.h -- plays telegraph sounder clicks along with the Morse code
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+#ifndef INCLUDED_sounder
+#define INCLUDED_sounder
+
+#include <Arduino.h>
+
+// A buzzer sounds nothing like the railroad sounder operators listened to. With WANT_SOUNDER
+// enabled (the #define line below is the *last* of the pair), the start of every Morse element
+// plays the sounder's "down" click and the end of it the "up" click, through a small amplifier
+// and speaker on Timer2's OC2B pin. The clicks are short ADPCM samples in program memory (see
+// sounder_samples.h), decoded by run_sounder() from loop() and played at about 7.8 kHz through
+// Timer2 as a 31 kHz PWM DAC.
+//
+// OC2B is pin 3 on an Uno, Nano or Pro Mini and pin 9 on a Mega; a Leonardo or Micro has no
+// Timer2 and can't have a sounder. The PWM output can't be moved to another pin, so the station
+// table must leave that pin alone, and none of the tables shipped in station_buzzers.ino does:
+// DAVID_PARKS and MRCS_REV2 read a hook switch on pin 3 and DAVE_ADAMS drives RO's buzzer with
+// it. Move that station to a free pin first; init_sounder() leaves the sounder off if any
+// station uses the OC2B pin.
+//
+// Only one station rings at a time, so all of the stations share the one sounder.
+#define WANT_SOUNDER
+#undef WANT_SOUNDER
+
+#ifdef WANT_SOUNDER
+
+void init_sounder();
+void run_sounder();
+void sounder_click(bool down);
+
+#else
+
+inline void init_sounder() { }
+inline void run_sounder() { }
+inline void sounder_click(bool down) { }
+
+#endif
+
+#endif
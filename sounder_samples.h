@@ -0,0 +1,41 @@
+// sounder_samples.h -- generated by tools/make_sounder_samples.py, do not edit
+//
+// 4-bit IMA ADPCM at 7843.1 Hz, low nibble first
+
+static const uint16_t sounder_down_samples = 313;
+static const uint8_t sounder_down_start_index = 86;
+static const uint8_t sounder_down_adpcm[] PROGMEM = {
+  0x59, 0x88, 0xaa, 0x04, 0x08, 0xaa, 0xa8, 0x07, 0x29, 0x8c, 0x12, 0x93, 0x0c, 0x2b, 0x94, 0xb8,
+  0x3b, 0x30, 0xb5, 0x98, 0x51, 0x80, 0xe0, 0x08, 0x20, 0xa9, 0xa8, 0x52, 0x10, 0xb9, 0x11, 0x23,
+  0xad, 0xab, 0x14, 0x80, 0x8d, 0x22, 0x05, 0x99, 0x0a, 0x03, 0xd0, 0x8c, 0x20, 0x93, 0x99, 0x58,
+  0x23, 0xc8, 0x8b, 0x30, 0xc0, 0xac, 0x30, 0x24, 0xb8, 0x28, 0x35, 0xb8, 0xae, 0x10, 0x81, 0xbb,
+  0x30, 0x27, 0x88, 0x8a, 0x23, 0xb1, 0xaf, 0x19, 0x12, 0xa9, 0x29, 0x36, 0x91, 0x9b, 0x38, 0xa1,
+  0xce, 0x19, 0x22, 0xa1, 0x19, 0x54, 0x81, 0xca, 0x19, 0x00, 0xcb, 0x0a, 0x53, 0x02, 0x8a, 0x42,
+  0x02, 0xdc, 0x8a, 0x11, 0xb8, 0x0a, 0x73, 0x12, 0x99, 0x18, 0x02, 0xfb, 0x9a, 0x11, 0x91, 0x89,
+  0x63, 0x13, 0xb8, 0x8a, 0x11, 0xeb, 0x9c, 0x30, 0x12, 0x88, 0x51, 0x23, 0xc8, 0xab, 0x08, 0xc8,
+  0xac, 0x31, 0x26, 0x80, 0x18, 0x23, 0xd8, 0xbc, 0x08, 0x80, 0xaa, 0x51, 0x34, 0x92, 0x89, 0x11,
+  0xd8, 0xbd, 0x09, 0x12, 0x88, 0x40, 0x35, 0x92, 0xaa, 0x09, 0xb9, 0xce, 0x09,
+};
+
+static const uint16_t sounder_up_samples = 219;
+static const uint8_t sounder_up_start_index = 88;
+static const uint8_t sounder_up_adpcm[] PROGMEM = {
+  0x11, 0x0d, 0x20, 0x98, 0x98, 0x94, 0xb0, 0x22, 0xa1, 0x1d, 0x20, 0xaa, 0x22, 0xd2, 0x89, 0x04,
+  0x8a, 0x48, 0x98, 0x1a, 0x94, 0xa9, 0x13, 0xc0, 0x4a, 0x01, 0x8d, 0x22, 0xd8, 0x20, 0x91, 0x0b,
+  0x32, 0xcb, 0x21, 0xc3, 0x0a, 0x04, 0xba, 0x51, 0xa8, 0x2a, 0x84, 0xba, 0x33, 0xc8, 0x3a, 0x03,
+  0x9e, 0x32, 0xd8, 0x28, 0x92, 0x8b, 0x33, 0xda, 0x48, 0xa1, 0x8a, 0x14, 0xba, 0x50, 0xa0, 0x1a,
+  0x04, 0xab, 0x41, 0xb0, 0x3b, 0x04, 0x9d, 0x32, 0xc8, 0x29, 0x93, 0x9b, 0x43, 0xc9, 0x49, 0xa2,
+  0x8b, 0x24, 0xca, 0x30, 0xa1, 0x1c, 0x13, 0xcb, 0x41, 0xb1, 0x2b, 0x04, 0x9c, 0x31, 0xc0, 0x29,
+  0x83, 0xac, 0x43, 0xb9, 0x39, 0x93, 0x8d, 0x23, 0xd9, 0x38, 0xa2, 0x0c, 0x23, 0x0b,
+};
+
+static const uint16_t adpcm_step_table[] PROGMEM = {
+  7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21,
+  23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66,
+  73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209,
+  230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658,
+  724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+  2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484,
+  7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350,
+  22385, 24623, 27086, 29794, 32767,
+};
@@ -32,6 +32,14 @@
 ///////////////////////////////////////////////////////////////////////////////////////////////
 #include "station_info.h"
 #include "station_states.h"
+#include "ring_bus.h"
+#include "profile.h"
+#include "memory_stats.h"
+#include "trace.h"
+#include "status_panel.h"
+#include "tasks.h"
+#include "console.h"
+#include "sounder.h"
 #include "avr/pgmspace.h"
 #include "DebugSerial.h"
 
@@ -56,6 +64,17 @@ const char version[] = "v2.0";
 // doesn't matter what you set the "station_code" to, as that field will only show up in debug
 // messages.
 //
+// When several stations are waiting to ring, the one that has waited longest normally goes first.
+// Setting "priority" to PRIORITY_HIGH (say for a junction tower) or PRIORITY_LOW (a flag stop)
+// moves a station ahead of or behind the others, but only by priority_step_msec per class (see
+// station_states.cpp), so a low priority station still gets its turn. Ambience stations only
+// ring when all of the other stations are idle, whatever their priority.
+//
+// "dot msec" sets a station's code speed (0 gives the standard 100 msec dot) and "space msec" the
+// space between the characters of its code (0 gives the standard 3 dots). A station with a long
+// code like "CO" can be sped up so it holds the buzzers for less time, while a longer space keeps
+// the characters easy to tell apart (Farnsworth spacing).
+//
 // Use of Arduino "analog" pins
 // ============================
 //
@@ -74,25 +93,28 @@ const char version[] = "v2.0";
 
 // MRCS Buzzer Board rev 2
 //
-// The second-generation buzzer board supports 7 stations plus an ambience buzzer
+// The second-generation buzzer board supports 7 stations plus an ambience buzzer. AA and BB
+// answer on pins 0 and 1, the serial port, so this board can't use WANT_REAL_SERIAL or join a
+// ring bus (see "Ring bus" below).
 #undef MRCS_REV2_TABLE
 #ifdef MRCS_REV2_TABLE
 const struct Station_Info stations[] = {
-  //                         buzzer       called      off_hook     timeout   station
-  //  station_type,        pin,active,  pin,active,  pin,active,   seconds,   code
-  {   STATION_MOMENTARY,    13, HIGH,      A0, LOW,       0, LOW,      0,       "AA"  },
-  {   STATION_MOMENTARY,    12, HIGH,      A1, LOW,       1, LOW,      0,       "BB"  }, 
-  {   STATION_MOMENTARY,    11, HIGH,      A2, LOW,       2, LOW,      0,       "CC"  },
-  {   STATION_MOMENTARY,    10, HIGH,      A3, LOW,       3, LOW,      0,       "DD"  },
-  {   STATION_MOMENTARY,     9, HIGH,      A4, LOW,       4, LOW,      0,       "EE"  },
-  {   STATION_MOMENTARY,     8, HIGH,      A5, LOW,       5, LOW,      0,       "FF"  },
-  {   STATION_MOMENTARY,     7, HIGH,      A6, LOW,      A7, LOW,      0,       "GG"  },
+  //                         buzzer       called      off_hook     timeout   station                   dot   space
+  //  station_type,        pin,active,  pin,active,  pin,active,   seconds,   code,   priority,        msec, msec
+  {   STATION_MOMENTARY,    13, HIGH,      A0, LOW,       0, LOW,      0,       "AA",   PRIORITY_NORMAL, 0,    0 },
+  {   STATION_MOMENTARY,    12, HIGH,      A1, LOW,       1, LOW,      0,       "BB",   PRIORITY_NORMAL, 0,    0 }, 
+  {   STATION_MOMENTARY,    11, HIGH,      A2, LOW,       2, LOW,      0,       "CC",   PRIORITY_NORMAL, 0,    0 },
+  {   STATION_MOMENTARY,    10, HIGH,      A3, LOW,       3, LOW,      0,       "DD",   PRIORITY_NORMAL, 0,    0 },
+  {   STATION_MOMENTARY,     9, HIGH,      A4, LOW,       4, LOW,      0,       "EE",   PRIORITY_NORMAL, 0,    0 },
+  {   STATION_MOMENTARY,     8, HIGH,      A5, LOW,       5, LOW,      0,       "FF",   PRIORITY_NORMAL, 0,    0 },
+  {   STATION_MOMENTARY,     7, HIGH,      A6, LOW,      A7, LOW,      0,       "GG",   PRIORITY_NORMAL, 0,    0 },
 
   // This demonstrates an "ambience" station which will buzz one of the random ambience messages
   // at a random time between 2/3 and 4/3 of the "timeout_sec". This station doesn't need
   // "answered" or "called" pins so they are set to -1. Also, the "station code' is ignored.
-  {   STATION_AMBIENCE,      6, HIGH,      -1, LOW,     -1, LOW,      60,       "MM"  },
+  {   STATION_AMBIENCE,      6, HIGH,      -1, LOW,     -1, LOW,      60,       "MM",   PRIORITY_LOW,    0,    0 },
 };
+const char station_table_name[] = "MRCS_REV2";
 #endif
 
 // David Parks Cumberland West
@@ -101,19 +123,20 @@ const struct Station_Info stations[] = {
 #define DAVID_PARKS_TABLE
 #ifdef DAVID_PARKS_TABLE
 const struct Station_Info stations[] = {
-  //                         buzzer       called      off_hook     timeout   station
-  //  station_type,        pin,active,  pin,active,  pin,active,   seconds,   code
-  {   STATION_NORMAL,      8, HIGH,      A0, LOW,       2, LOW,      0,       "ND" }, // Viaduct
-  {   STATION_NORMAL,      9, HIGH,      A1, LOW,       3, LOW,      0,       "GE" }, // Evitts
-  {   STATION_NORMAL,     10, HIGH,      A2, LOW,       4, LOW,      0,       "KY" }, // Keyser
-  {   STATION_NORMAL,     11, HIGH,      A3, LOW,       5, LOW,      0,       "CO" }, // McKenxie
-  {   STATION_NORMAL,     12, HIGH,      A4, LOW,       6, LOW,      0,       "P"  }, // Piedmont
+  //                         buzzer       called      off_hook     timeout   station                   dot   space
+  //  station_type,        pin,active,  pin,active,  pin,active,   seconds,   code,   priority,        msec, msec
+  {   STATION_NORMAL,      8, HIGH,      A0, LOW,       2, LOW,      0,       "ND",  PRIORITY_NORMAL, 0,    0 }, // Viaduct
+  {   STATION_NORMAL,      9, HIGH,      A1, LOW,       3, LOW,      0,       "GE",  PRIORITY_NORMAL, 0,    0 }, // Evitts
+  {   STATION_NORMAL,     10, HIGH,      A2, LOW,       4, LOW,      0,       "KY",  PRIORITY_NORMAL, 0,    0 }, // Keyser
+  {   STATION_NORMAL,     11, HIGH,      A3, LOW,       5, LOW,      0,       "CO",  PRIORITY_NORMAL, 0,    0 }, // McKenxie
+  {   STATION_NORMAL,     12, HIGH,      A4, LOW,       6, LOW,      0,       "P",   PRIORITY_NORMAL, 0,    0 }, // Piedmont
 
   // This demonstrates an "ambience" station which will buzz one of the random ambience messages
   // at a random time between 2/3 and 4/3 of the "timeout_sec". This station doesn't need
   // "answered" or "called" pins so they are set to -1. Also, the "station code' is ignored.
-  {   STATION_AMBIENCE,   13, HIGH,        -1, LOW,     -1, LOW,      60,       "DS" }, // Dispatcher
+  {   STATION_AMBIENCE,   13, HIGH,        -1, LOW,     -1, LOW,      60,       "DS",  PRIORITY_LOW,    0,    0 }, // Dispatcher
 };
+const char station_table_name[] = "DAVID_PARKS";
 #endif
 
 
@@ -128,20 +151,57 @@ const struct Station_Info stations[] = {
 #undef DAVE_ADAMS_TABLE
 #ifdef DAVE_ADAMS_TABLE
 const struct Station_Info stations[] = {
-  //                         buzzer       called      off_hook     timeout   station
-  //  station_type,        pin,active,  pin,active,  pin,active,   seconds,   code
-  {   STATION_MOMENTARY,   11, HIGH,      A0, LOW,     2, LOW,       30,      "DW" }, // West Durango
-  {   STATION_MOMENTARY,   10, HIGH,      A1, LOW,     4, LOW,       30,      "HF" }, // Hesperus
-  {   STATION_MOMENTARY,    9, HIGH,      A2, LOW,     7, LOW,       30,      "CA" }, // Cima Summit
-  {   STATION_MOMENTARY,    6, HIGH,      A3, LOW,     8, LOW,       30,      "MX" }, // Mancos
-  {   STATION_MOMENTARY,    5, HIGH,      A4, LOW,    12, LOW,       30,      "DJ" }, // Dolores
-  {   STATION_MOMENTARY,    3, HIGH,      A5, LOW,    13, LOW,       30,      "RO" }, // Rico
+  //                         buzzer       called      off_hook     timeout   station                   dot   space
+  //  station_type,        pin,active,  pin,active,  pin,active,   seconds,   code,   priority,        msec, msec
+  {   STATION_MOMENTARY,   11, HIGH,      A0, LOW,     2, LOW,       30,      "DW",  PRIORITY_NORMAL, 0,    0 }, // West Durango
+  {   STATION_MOMENTARY,   10, HIGH,      A1, LOW,     4, LOW,       30,      "HF",  PRIORITY_NORMAL, 0,    0 }, // Hesperus
+  {   STATION_MOMENTARY,    9, HIGH,      A2, LOW,     7, LOW,       30,      "CA",  PRIORITY_NORMAL, 0,    0 }, // Cima Summit
+  {   STATION_MOMENTARY,    6, HIGH,      A3, LOW,     8, LOW,       30,      "MX",  PRIORITY_NORMAL, 0,    0 }, // Mancos
+  {   STATION_MOMENTARY,    5, HIGH,      A4, LOW,    12, LOW,       30,      "DJ",  PRIORITY_NORMAL, 0,    0 }, // Dolores
+  {   STATION_MOMENTARY,    3, HIGH,      A5, LOW,    13, LOW,       30,      "RO",  PRIORITY_NORMAL, 0,    0 }, // Rico
 };
+const char station_table_name[] = "DAVE_ADAMS";
 #endif
 const int num_stations = sizeof(stations) / sizeof(stations[0]);
 
+// Ring bus
+//
+// When several boards share a layout, enable WANT_RING_BUS in ring_bus.h and connect the boards'
+// serial ports to a common RS-485 (or wired-OR) bus. Give each board its own node id, counting
+// up from 0, and set ring_bus_num_nodes to the number of boards. If the RS-485 transceiver has a
+// driver-enable input, set ring_bus_tx_enable_pin to the pin driving it, otherwise to -1.
+//
+// On an Uno, Nano or Pro Mini the bus takes over Serial, and so pins 0 and 1, which the
+// MRCS_REV2 table uses for the AA and BB off_hook inputs. Such a board can't join a bus with
+// that table (init_ring_bus() leaves the bus alone and the board rings on its own); a
+// Leonardo, Micro or Mega uses Serial1 for the bus instead.
+#ifdef WANT_RING_BUS
+const uint8_t ring_bus_node_id = 0;
+const uint8_t ring_bus_num_nodes = 2;
+const int8_t  ring_bus_tx_enable_pin = -1;
+#endif
+
+// Status panel
+//
+// When WANT_STATUS_PANEL is enabled in status_panel.h, list the row pins here, one per station
+// in the same order as the stations table, and the column pins for the RING_WAITING,
+// RING_PLAYING, TALKING and HANGUP_WAIT LEDs. The panel uses Timer1. The pins below are an example
+// for an Arduino Mega; they must not overlap any of the pins in the stations table. Pins 22 and
+// up exist only on a Mega, and none of the tables above leaves an Uno or Nano enough free pins
+// for a panel, so on other boards you must pick the pins yourself. init_status_panel() leaves
+// the panel dark if any pin doesn't exist or is used by a station.
+#ifdef WANT_STATUS_PANEL
+#if !defined(ARDUINO_AVR_MEGA2560) && !defined(__AVR_ATmega2560__) && !defined(__AVR_ATmega1280__)
+#error "The status panel pins below are for an Arduino Mega; list this board's own pins"
+#endif
+const uint8_t status_panel_row_pins[] = { 22, 23, 24, 25, 26, 27 };
+const uint8_t status_panel_num_rows = sizeof(status_panel_row_pins) / sizeof(status_panel_row_pins[0]);
+const uint8_t status_panel_column_pins[status_panel_columns] = { 30, 31, 32, 33 };
+#endif
+
 // The messages played by the ambience sations are defined here. We are playing Arduino AVR tricks
-// here to place the strings themselves in the Arduino's larger program memory.
+// here to place the strings themselves in the Arduino's larger program memory, and the ambience
+// station plays them from there directly without copying them into the much smaller SRAM.
 //
 // You can add as many messages as you need, limited only by the code space in your Arduino.  Adding
 // a message is a two-step process -- first, you need to add a declaration for the string itself
@@ -157,6 +217,22 @@ const char * const ambience_messages[] PROGMEM = {
 const int num_ambience_messages = sizeof(ambience_messages) / sizeof(ambience_messages[0]);
 
 
+static bool memory_stats_task(Task_Context *ctx)
+{
+  run_memory_stats();
+  return false;
+}
+
+// The auxiliary tasks, run after the stations have been serviced on each pass through loop()
+// (see tasks.h). The budget is how long a task may run in one pass, and the deadline is how
+// often it should get a turn.
+Task tasks[] = {
+  // name      run                budget usec  deadline msec
+  { "console", run_console,       500,         100  },
+  { "memory",  memory_stats_task, 100,         1000 },
+};
+const uint8_t num_tasks = sizeof(tasks) / sizeof(tasks[0]);
+
 void setup()
 {
   DebugSerial_begin(9600);
@@ -164,10 +240,22 @@ void setup()
   DebugSerial_print(F("Station Buzzers "));
   DebugSerial_println(version);
 
+  init_ring_bus();
   init_station_states();
+  init_status_panel();
+  init_sounder();
+  trace_begin();
+  init_tasks();
 }
 
 void loop()
 {
+  run_ring_bus();
+  run_sounder();
+
+  profile_tick_begin();
   run_station_states();
+  profile_tick_end();
+
+  run_tasks();
 }
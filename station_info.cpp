@@ -16,6 +16,8 @@
 #include "Arduino.h"
 #include "morse.h"
 #include <limits.h>
+#include "trace.h"
+#include "morse_injection.h"
 #include "DebugSerial.h"
 
 void Station_Info::enter_idle()
@@ -23,7 +25,7 @@ void Station_Info::enter_idle()
   called_latch_ = false;
   called_debounce_ = off_hook_debounce_ = false;
   called_millis_   = off_hook_millis_   = millis();
-  morse_.setup(buzzer_pin_, buzzer_active_ == HIGH);
+  morse_.setup(buzzer_pin_, buzzer_active_ == HIGH, dot_msec_, char_space_msec_);
   if (is_ambience()) {
     // Make up the time that we will next play an ambience message
     const int ambience_idx = random(0, num_ambience_messages);
@@ -57,8 +59,11 @@ void Station_Info::enter_ring_waiting()
 
 void Station_Info::enter_ring_playing()
 {
-  if (is_ambience()) {
-    morse_.start(ambience_message_.c_str());
+  if (morse_injection_pending(this)) {
+    morse_.start_stream(morse_injection_next_char);
+    DebugSerial_println(F("playing injected text"));
+  } else if (is_ambience()) {
+    morse_.start(ambience_message_);
     DebugSerial_println(ambience_message_);
   } else {
     morse_.start(station_code_);
@@ -104,6 +109,10 @@ bool Station_Info::called()
   // when the station enters IDLE state, and stays "called" until it
   // finishes ringing one time.  This is all managed in enter_ring_waiting()
   if (is_ambience()) {
+    // Text injected over the serial port rings the station as soon as it gets its turn
+    if (morse_injection_pending(this))
+      return true;
+
     // Deal with unwrapping for those cases the layout stays on for more than 24.8 days
     signed long diff_ring = (now_millis - next_call_millis_);
     return (0 < diff_ring && diff_ring < LONG_MAX);
@@ -115,6 +124,7 @@ bool Station_Info::called()
   bool is_called = read_input_pin(called_pin_, called_active_);
   bool called_changed = ((is_called != called_debounce_) && (20 < diff_called) && (diff_called < LONG_MAX));
   called_debounce_ = is_called;
+  trace_called(this - stations, is_called);
 
   if (!is_momentary()) {
     if (called_changed) {
@@ -163,6 +173,7 @@ bool Station_Info::off_hook()
   const unsigned long now_millis = millis();
   const signed long diff_off_hook = (now_millis - off_hook_millis_);
   off_hook_debounce_ = is_off_hook;
+  trace_off_hook(this - stations, is_off_hook);
 
   if ((is_off_hook != was_off_hook) && (20 <= diff_off_hook) && (diff_off_hook < LONG_MAX)) {
     // React to change on "off_hook"
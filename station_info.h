@@ -33,6 +33,12 @@ enum Station_Type {
   STATION_AMBIENCE
 };
 
+enum Station_Priority {
+  PRIORITY_LOW,
+  PRIORITY_NORMAL,
+  PRIORITY_HIGH
+};
+
 #define ANALOG_IN ((uint8_t) 0x80)
 #define ANALOG_LOW (ANALOG_IN | LOW)
 #define ANALOG_HIGH (ANALOG_IN | HIGH)
@@ -58,6 +64,11 @@ struct Station_Info {
 
   const char * const station_code_;
 
+  Station_Priority   priority_;         // Which station rings first when several are waiting
+
+  uint16_t           dot_msec_;         // Code speed, 0 for the standard 100 msec dot
+  uint16_t           char_space_msec_;  // Space between characters, 0 for the standard 3 dots
+
   //////////////////////////////////////////////////////////////////////////////
   // Member fields below this point are not initialized in the table, but rather
   // when enter_idle() is first called
@@ -74,7 +85,7 @@ struct Station_Info {
   bool               off_hook_debounce_;
   unsigned long      off_hook_millis_;
 
-  String             ambience_message_;
+  const __FlashStringHelper *ambience_message_;  // PROGMEM, played without copying
   
   //////////////////////////////////////////////////////////////////////////
   // Member methods
@@ -93,13 +104,14 @@ struct Station_Info {
   void enter_ring_playing();
   void enter_talking();
   void enter_hangup_wait();
-  unsigned waiting_msec() { return millis() - wait_enter_millis_; }
+  unsigned long waiting_msec() { return millis() - wait_enter_millis_; }
  private:
   void buzzer_off() { digitalWrite(buzzer_pin_, (buzzer_active_ == HIGH) ? LOW : HIGH ); }
 };
 
 extern const struct Station_Info stations[];
 extern const int num_stations;
+extern const char station_table_name[];
 extern const char * const ambience_messages[] PROGMEM;
 extern const int num_ambience_messages;
 
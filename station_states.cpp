@@ -16,6 +16,10 @@
 #include <limits.h>
 #include "station_states.h"
 #include "station_info.h"
+#include "ring_bus.h"
+#include "buzzer_output.h"
+#include "trace.h"
+#include "status_panel.h"
 #include "DebugSerial.h"
 
 // Function callback types for the enter / state / exit conditions of each state
@@ -37,11 +41,20 @@ static Station_Info *current_ringer = 0;
 // last_ring_time: the mills() value when the most recent ringing station completed ringing
 static unsigned long last_ring_millis = 0;
 
+// ring_start_millis: the millis() value when current_ringer started ringing
+static unsigned long ring_start_millis = 0;
+
 // ring_silence_interval: the minimum interval between completion (or interruption) of one ring
 // and starting the next.
 static const unsigned ring_silence_interval = 2000;
 static const unsigned ambience_silence_interval = 10000;
 
+// priority_step_msec: each priority class a station is above another counts as having waited
+// this much longer. The waiting time keeps growing, so a low priority station waiting that much
+// longer than a higher one still rings first and can't be starved. host/priority_wait shows
+// what that does to each class's time to first ring over a busy session.
+static const unsigned long priority_step_msec = 15000;
+
 // Forward declaration for the state transition function.
 static void goto_state(Station_Info *station, enum Station_States next_state);
 
@@ -98,6 +111,7 @@ void
 ring_playing_enter(struct Station_Info *station)
 {
   current_ringer = station;
+  ring_start_millis = millis();
   station->enter_ring_playing();
 }
 
@@ -117,6 +131,12 @@ ring_playing_state(struct Station_Info *station)
     return;
   }
 
+  if (!ring_bus_holding()) {
+    // Another board turned out to hold the ring token too, and kept it; ring again later
+    goto_state(station, RING_WAITING);
+    return;
+  }
+
   if (!station->still_playing())
     goto_state(station, station->is_ambience() ? IDLE : RING_WAITING);
 }
@@ -205,9 +225,19 @@ goto_state(struct Station_Info *station, Station_States next_state)
     Enter_Callback enter_cb = callback_table[next_state].enter_callback;
     if (enter_cb != 0)
       (*enter_cb)(station);
+
+    trace_state(station - stations, next_state);
+    status_panel_show(station - stations, next_state);
   }
 }
 
+// The age used to pick the next ringer: the time spent waiting plus the priority class
+static inline unsigned long
+ring_age(Station_Info *station)
+{
+  return station->waiting_msec() + station->priority_ * priority_step_msec;
+}
+
 void
 choose_next_ringer()
 {
@@ -221,7 +251,7 @@ choose_next_ringer()
     return;
 
   // Scan for "normal" (non ambience) stations that could ring
-  unsigned next_age = 0;
+  unsigned long next_age = 0;
   Station_Info *next_ringer = 0;
   bool all_normal_stations_idle = true;
   for (int ii = 0; ii < num_stations; ii++) {
@@ -230,7 +260,7 @@ choose_next_ringer()
     if (station->state() != IDLE) all_normal_stations_idle = false;
     if (station->state() != RING_WAITING) continue;
 
-    const unsigned station_age = station->waiting_msec();
+    const unsigned long station_age = ring_age(station);
     if (station_age > next_age) {
       // This one is a candidate for next_ringer
       next_ringer = station;
@@ -252,7 +282,7 @@ choose_next_ringer()
       if (!station->is_ambience()) continue;
       if (station->state() != RING_WAITING) continue;
   
-      const unsigned station_age = station->waiting_msec();
+      const unsigned long station_age = ring_age(station);
       if (station_age > next_age) {
         // This one is a candidate for next_ringer
         next_ringer = station;
@@ -261,12 +291,83 @@ choose_next_ringer()
     }
   }
   
-  if (next_ringer) {
-    DebugSerial_print(F("station ")); DebugSerial_print(next_ringer->station_code()); DebugSerial_println(F(" will ring next"));
-    goto_state(next_ringer, RING_PLAYING);
+  if (!next_ringer) {
+    ring_bus_release_token();
+    return;
+  }
+
+  // On a multi-board layout, only the board holding the ring token may start a ring, and only
+  // one ring per visit of the token.
+  if (!ring_bus_may_ring())
+    return;
+
+  DebugSerial_print(F("station ")); DebugSerial_print(next_ringer->station_code()); DebugSerial_println(F(" will ring next"));
+  ring_bus_token_used();
+  goto_state(next_ringer, RING_PLAYING);
+}
+
+#ifdef WANT_INVARIANT_CHECKS
+
+// The longest a ring should take: a long ambience message, or a station code while the layout
+// is very busy. An injected message typed in slowly could legitimately take longer.
+static const unsigned long max_ring_msec = 120000;
+
+// The longest a station should wait to ring, plus the 60 second head start that
+// enter_ring_waiting() gives it. Ambience stations wait for the layout to go quiet, so they
+// aren't checked.
+static const unsigned long max_wait_msec = 60000 + 180000;
+
+enum Invariant {
+  INVARIANT_ONE_RINGER    = 0x1,
+  INVARIANT_RING_LENGTH   = 0x2,
+  INVARIANT_WAIT_LENGTH   = 0x4
+};
+static uint8_t invariants_reported = 0;
+
+static void
+invariant_failed(Invariant invariant, const __FlashStringHelper *what, Station_Info *station)
+{
+  if (invariants_reported & invariant)
+    return;
+  invariants_reported |= invariant;
+  DebugSerial_print(millis(), DEC);
+  DebugSerial_print(F(" INVARIANT FAILED: "));
+  DebugSerial_print(what);
+  DebugSerial_print(F(" "));
+  DebugSerial_println(station->station_code());
+}
+
+static void
+check_invariants()
+{
+  const unsigned long now_millis = millis();
+  for (int ii = 0; ii < num_stations; ii++) {
+    Station_Info * const station = &stations[ii];
+    switch (station->state()) {
+      case RING_PLAYING:
+        if (station != current_ringer)
+          invariant_failed(INVARIANT_ONE_RINGER, F("ringing but not current_ringer"), station);
+        else if (now_millis - ring_start_millis > max_ring_msec)
+          invariant_failed(INVARIANT_RING_LENGTH, F("stuck in RING_PLAYING"), station);
+        break;
+      case RING_WAITING:
+        if (!station->is_ambience() && (station->waiting_msec() > max_wait_msec))
+          invariant_failed(INVARIANT_WAIT_LENGTH, F("starved in RING_WAITING"), station);
+        break;
+      default:
+        if (station == current_ringer)
+          invariant_failed(INVARIANT_ONE_RINGER, F("current_ringer but not ringing"), station);
+        break;
+    }
   }
 }
 
+#else
+
+static inline void check_invariants() { }
+
+#endif
+
 void
 init_station_states()
 {
@@ -288,4 +389,9 @@ run_station_states()
 
   if (!current_ringer)
     choose_next_ringer();
+
+  // Now switch every buzzer that changed during this pass at once
+  buzzer_output_commit();
+
+  check_invariants();
 }
@@ -16,6 +16,17 @@
 #ifndef INCLUDED_station_states
 #define INCLDUED_station_states
 
+// With WANT_INVARIANT_CHECKS enabled (the #define line below is the *last* of the pair), every
+// pass through run_station_states() also checks that the state machine is behaving: at most one
+// station is ringing and it is current_ringer, no ring lasts longer than max_ring_msec, and no
+// station waits longer than max_wait_msec for its turn. Each kind of failure is reported once
+// through the debug serial output, so enable WANT_REAL_SERIAL in DebugSerial.h as well.
+#define WANT_INVARIANT_CHECKS
+#undef WANT_INVARIANT_CHECKS
+
+// The name of each Station_States value, for debug output and the serial console
+extern const char * const state_names[];
+
 void init_station_states();
 
 void run_station_states();
@@ -0,0 +1,158 @@
+// status_panel.cpp -- multiplexed LED panel showing the state of every station
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+#include "status_panel.h"
+#include "station_info.h"
+#include "DebugSerial.h"
+
+#ifdef WANT_STATUS_PANEL
+
+static const uint8_t  panel_max_rows = 16;
+static const unsigned panel_refresh_hz = 100;   // each row is lit this many times a second
+
+// The output register and bit of each row and column pin, looked up once so that the
+// interrupt handler doesn't have to go through digitalWrite()
+struct Panel_Pin {
+  volatile uint8_t *out;
+  uint8_t           mask;
+};
+static Panel_Pin row_pin[panel_max_rows];
+static Panel_Pin column_pin[status_panel_columns];
+static uint8_t   panel_rows = 0;
+
+// The column bits for each row. status_panel_show() builds the next frame in the one the
+// interrupt handler isn't using and then flips front_frame, a single byte write, so the handler
+// always scans a complete frame.
+static uint8_t          frame[2][panel_max_rows];
+static volatile uint8_t front_frame = 0;
+static uint8_t          scan_row = 0;
+
+static inline void
+pin_high(const Panel_Pin &pin)
+{
+  *pin.out |= pin.mask;
+}
+
+static inline void
+pin_low(const Panel_Pin &pin)
+{
+  *pin.out &= ~pin.mask;
+}
+
+// A pin the panel may drive: one that exists on this board, has a port behind it (A6 and A7
+// on a 328P don't), and isn't wired to a station. The interrupt handler writes through the
+// looked-up port register with no further checks, so a bad pin must never get that far.
+static bool
+panel_pin_ok(uint8_t pin)
+{
+  if ((pin >= NUM_DIGITAL_PINS) || (digitalPinToPort(pin) == NOT_A_PORT)) {
+    DebugSerial_print(F("status panel: no such pin ")); DebugSerial_println(pin);
+    return false;
+  }
+  for (int ii = 0; ii < num_stations; ii++) {
+    const Station_Info &station = stations[ii];
+    if ((pin == station.buzzer_pin_) || (pin == station.called_pin_) || (pin == station.off_hook_pin_)) {
+      DebugSerial_print(F("status panel: pin ")); DebugSerial_print(pin);
+      DebugSerial_println(F(" is used by a station"));
+      return false;
+    }
+  }
+  return true;
+}
+
+static Panel_Pin
+panel_pin_setup(uint8_t pin, uint8_t level)
+{
+  pinMode(pin, OUTPUT);
+  digitalWrite(pin, level);
+  Panel_Pin panel_pin = { portOutputRegister(digitalPinToPort(pin)), digitalPinToBitMask(pin) };
+  return panel_pin;
+}
+
+// One row per interrupt, panel_refresh_hz times a second for each row: 600 interrupts a second
+// with 6 rows. Reading the code, the handler comes to about 90 cycles with the register saves,
+// under 6 usec at 16 MHz or about 0.3% of the CPU with 6 rows; that count hasn't been timed on a
+// board. host/status_panel_sim runs it at its OCR1A rate between loop() passes, charging each
+// entry 20 usec: every scan lights the right row and columns, and check_morse_vcd.py finds no
+// Morse edge more than 0.1 msec off (none at all with the handler free), as an edge can only
+// be held up by the handler's own run time.
+ISR(TIMER1_COMPA_vect)
+{
+  // Blank the row we have been showing, set up the columns for the next one, and light it
+  pin_high(row_pin[scan_row]);
+  if (++scan_row >= panel_rows)
+    scan_row = 0;
+
+  const uint8_t columns = frame[front_frame][scan_row];
+  for (uint8_t col = 0; col < status_panel_columns; col++) {
+    if (columns & (1 << col))
+      pin_high(column_pin[col]);
+    else
+      pin_low(column_pin[col]);
+  }
+  pin_low(row_pin[scan_row]);
+}
+
+void
+init_status_panel()
+{
+  panel_rows = status_panel_num_rows;
+  if (panel_rows > num_stations)
+    panel_rows = num_stations;
+  if (panel_rows > panel_max_rows)
+    panel_rows = panel_max_rows;
+  if (panel_rows == 0)
+    return;
+
+  // Check every pin before touching any of them, and leave the panel dark if one is bad
+  bool pins_ok = true;
+  for (uint8_t row = 0; row < panel_rows; row++)
+    pins_ok = panel_pin_ok(status_panel_row_pins[row]) && pins_ok;
+  for (uint8_t col = 0; col < status_panel_columns; col++)
+    pins_ok = panel_pin_ok(status_panel_column_pins[col]) && pins_ok;
+  if (!pins_ok) {
+    panel_rows = 0;
+    return;
+  }
+
+  for (uint8_t row = 0; row < panel_rows; row++)
+    row_pin[row] = panel_pin_setup(status_panel_row_pins[row], HIGH);
+  for (uint8_t col = 0; col < status_panel_columns; col++)
+    column_pin[col] = panel_pin_setup(status_panel_column_pins[col], LOW);
+
+  // Timer1 in CTC mode with a prescaler of 64 (250 kHz at 16 MHz), interrupting once per row
+  const uint8_t old_sreg = SREG;
+  cli();
+  TCCR1A = 0;
+  TCCR1B = _BV(WGM12) | _BV(CS11) | _BV(CS10);
+  OCR1A = (F_CPU / 64) / (panel_refresh_hz * panel_rows) - 1;
+  TIMSK1 |= _BV(OCIE1A);
+  SREG = old_sreg;
+}
+
+void
+status_panel_show(int station_idx, uint8_t state)
+{
+  if ((station_idx < 0) || (station_idx >= panel_rows))
+    return;
+
+  // IDLE is dark; RING_WAITING through HANGUP_WAIT light columns 0 through 3
+  const uint8_t back_frame = 1 - front_frame;
+  memcpy(frame[back_frame], frame[front_frame], panel_rows);
+  frame[back_frame][station_idx] = (state == IDLE) ? 0 : (1 << (state - RING_WAITING));
+  front_frame = back_frame;
+}
+
+#endif
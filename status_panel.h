@@ -0,0 +1,50 @@
+// status_panel.h -- multiplexed LED panel showing the state of every station
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+#ifndef INCLUDED_status_panel
+#define INCLUDED_status_panel
+
+#include <Arduino.h>
+
+// With WANT_STATUS_PANEL enabled (the #define line below is the *last* of the pair), the
+// dispatcher's panel shows the state of every station on an LED matrix: one row per station,
+// in the order of the stations table, and one column each for RING_WAITING, RING_PLAYING,
+// TALKING and HANGUP_WAIT (IDLE leaves the row dark). The row and column pins are listed in
+// station_buzzers.ino; rows sink current (active LOW) and columns source it (active HIGH).
+//
+// The rows are scanned from a Timer1 compare interrupt, so the display never flickers however
+// long loop() takes. The state machine only calls status_panel_show() when a station changes
+// state, which builds a new frame and flips it in for the interrupt to pick up.
+#define WANT_STATUS_PANEL
+#undef WANT_STATUS_PANEL
+
+#ifdef WANT_STATUS_PANEL
+
+static const uint8_t status_panel_columns = 4;
+extern const uint8_t status_panel_row_pins[];
+extern const uint8_t status_panel_num_rows;
+extern const uint8_t status_panel_column_pins[status_panel_columns];
+
+void init_status_panel();
+void status_panel_show(int station_idx, uint8_t state);
+
+#else
+
+inline void init_status_panel() { }
+inline void status_panel_show(int station_idx, uint8_t state) { }
+
+#endif
+
+#endif
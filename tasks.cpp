@@ -0,0 +1,89 @@
+// tasks.cpp -- cooperative scheduling of the sketch's auxiliary work
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+
+#include "tasks.h"
+
+// The time the tasks may take between them on each pass through loop(). Morse elements are
+// timed in milliseconds, so the stations should be serviced at least that often.
+static const unsigned long task_window_usec = 1000;
+
+// The task that starts the next pass, so that a task left out when the window ran out goes
+// first next time
+static uint8_t next_task = 0;
+
+static void
+run_task(Task *task)
+{
+  const unsigned long start_micros = micros();
+  task->last_run_millis_ = millis();
+  task->late_ = false;
+
+  bool more;
+  do {
+    const unsigned long step_micros = micros();
+    more = (*task->run_)(&task->context_);
+    const unsigned long step_usec = micros() - step_micros;
+    if (step_usec > task->max_step_usec_)
+      task->max_step_usec_ = (step_usec > 0xffff) ? 0xffff : step_usec;
+  } while (more && (micros() - start_micros < task->budget_usec_));
+}
+
+void
+init_tasks()
+{
+  // Start the deadlines from the end of setup(), not from power on
+  const unsigned long now_millis = millis();
+  for (uint8_t ii = 0; ii < num_tasks; ii++)
+    tasks[ii].last_run_millis_ = now_millis;
+}
+
+void
+run_tasks()
+{
+  if (num_tasks == 0)
+    return;
+
+  const unsigned long window_start = micros();
+  const unsigned long now_millis = millis();
+
+  // A task that is past its deadline starts this pass, the latest one if there are several
+  uint8_t first = next_task;
+  unsigned long most_late = 0;
+  for (uint8_t ii = 0; ii < num_tasks; ii++) {
+    Task * const task = &tasks[ii];
+    const unsigned long since_run = now_millis - task->last_run_millis_;
+    if (since_run > task->deadline_msec_) {
+      // Count each late period once, however many passes it takes for the task to get its turn
+      if (!task->late_) {
+        task->late_ = true;
+        task->missed_deadlines_++;
+      }
+      if (since_run - task->deadline_msec_ > most_late) {
+        most_late = since_run - task->deadline_msec_;
+        first = ii;
+      }
+    }
+  }
+
+  // The first task always gets its turn, the rest only while the window lasts
+  uint8_t ran = 0;
+  do {
+    run_task(&tasks[(first + ran) % num_tasks]);
+    ran++;
+  } while ((ran < num_tasks) && (micros() - window_start < task_window_usec));
+
+  next_task = (first + ((ran < num_tasks) ? ran : 1)) % num_tasks;
+}
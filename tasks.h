@@ -0,0 +1,87 @@
+// tasks.h -- cooperative scheduling of the sketch's auxiliary work
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+
+#ifndef INCLUDED_tasks
+#define INCLUDED_tasks
+
+#include <Arduino.h>
+
+// Everything on the board other than the stations themselves (the serial console, memory
+// checks, and whatever comes next) runs as a task from run_tasks(), which loop() calls after
+// run_station_states(). The stations are therefore always serviced first, and the tasks share
+// what is left of task_window_usec. Each task has its own budget for one pass through loop(),
+// and a deadline: a task that hasn't had a turn for deadline_msec goes first on the next pass,
+// and the miss is counted so that it shows up in the console's "T" report.
+//
+// A task is written as a stackless coroutine ("protothread"): a function that is called again
+// and again and carries on each time from the point where it last gave up the processor.
+//
+//   bool my_task(Task_Context *ctx)
+//   {
+//     static uint8_t ii;             // locals don't survive a yield, so make them static
+//     TASK_BEGIN(ctx);
+//     while (1) {
+//       TASK_WAIT_UNTIL(ctx, Serial.available() > 0);
+//       for (ii = 0; ii < 10; ii++) {
+//         do_a_bit_of_work(ii);
+//         TASK_YIELD(ctx);
+//       }
+//     }
+//     TASK_END(ctx);
+//   }
+//
+// TASK_YIELD returns true ("more to do"), and the task is called again at once if its budget
+// allows. TASK_WAIT_UNTIL returns false while the condition is false, and the scheduler moves on
+// to the next task. Each stretch of code between two of these should be short -- well under a
+// millisecond -- since nothing can interrupt it. The macros are built on a switch statement, so
+// a task must not use a switch of its own around a yield.
+
+struct Task_Context {
+  unsigned resume_line_;   // __LINE__ of the yield to carry on from, 0 to start at the top
+};
+
+#define TASK_BEGIN(ctx)  switch ((ctx)->resume_line_) { case 0:
+#define TASK_YIELD(ctx)  do { (ctx)->resume_line_ = __LINE__; return true; case __LINE__: ; } while (0)
+#define TASK_WAIT_UNTIL(ctx, cond) \
+  do { (ctx)->resume_line_ = __LINE__; case __LINE__: if (!(cond)) return false; } while (0)
+#define TASK_END(ctx)    } (ctx)->resume_line_ = 0; return false
+
+struct Task {
+  //////////////////////////////////////////////////////////////////////////
+  // Fields initialized through the "tasks" table in station_buzzers.ino
+  //////////////////////////////////////////////////////////////////////////
+  const char        *name_;
+  bool             (*run_)(Task_Context *ctx);
+  uint16_t           budget_usec_;    // most time the task gets in one pass through loop()
+  uint16_t           deadline_msec_;  // the task should get a turn at least this often
+
+  //////////////////////////////////////////////////////////////////////////
+  // Member fields below this point are not initialized in the table
+  //////////////////////////////////////////////////////////////////////////
+  Task_Context       context_;
+  unsigned long      last_run_millis_;
+  uint16_t           max_step_usec_;  // longest single call, i.e. longest stretch between yields
+  uint16_t           missed_deadlines_;
+  bool               late_;           // past its deadline, and already counted as a miss
+};
+
+extern Task tasks[];
+extern const uint8_t num_tasks;
+
+void init_tasks();
+void run_tasks();
+
+#endif
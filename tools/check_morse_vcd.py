@@ -0,0 +1,148 @@
+#!/usr/bin/env python3
+# check_morse_vcd.py -- check buzzer timing in a station_buzzers VCD trace
+#   Copyright (c) 2026, the station_buzzers contributors
+#
+# This program is free software; you can redistribute it and/or modify it under the terms of
+# the GNU General Public License as published by the Free Software Foundation; either version
+# 2 of the License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+# without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# See the GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License along with this program;
+# if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+# Boston, MA 02110-1301, USA.
+#
+# Reads a trace captured with WANT_VCD_TRACE (see trace.h) and compares every buzzer on-time and
+# off-time with the nearest length American Morse allows, in units of dot_time:
+#
+#   on:  1 (dot), 2 (dash), 4 (L), 5 (zero)
+#   off: 1 (within a character), 2 (the "dot space" in C, O, R, ...), 4 (between characters),
+#        11 (word space)
+#
+# With Farnsworth spacing, the 3 dots of space added at the end of each character become
+# char_space, and the word space is stretched to match, as in morse.cpp.
+#
+# Each buzzer can have its own code speed. trace_begin() writes every buzzer's dot and
+# character space into the header as
+#
+#   $comment timing CO_buzzer dot_ms=60 char_space_ms=300 $end
+#
+# and those are used where present. --station CO=60,300 sets them for one buzzer by its station
+# code, overriding the trace; --dot-ms and --char-space-ms apply to any buzzer that has neither
+# (a trace from an older build, say).
+#
+# Off-times longer than a word space are the pauses between rings and are not checked. The file
+# is read a line at a time, so captures of any length can be checked. A trace with no buzzer
+# elements in it at all fails.
+#
+# usage: check_morse_vcd.py [--dot-ms 100] [--char-space-ms 300] [--station CODE=DOT,SPACE ...]
+#                           [--tolerance-ms 5] trace.vcd
+
+import argparse
+import sys
+
+ON_UNITS = (1, 2, 4, 5)
+
+
+def off_lengths(dot_us, char_space_us):
+    """The allowed off-times in usec, see MorseBuzzer::setup() and next_morse_bit()"""
+    word_space_us = 4 * char_space_us / 3
+    return (dot_us, 2 * dot_us, dot_us + char_space_us,
+            dot_us + 2 * char_space_us + word_space_us)
+
+
+def element_lengths(dot_ms, char_space_ms):
+    """The allowed on-times and off-times in usec, keyed by the level before the edge"""
+    dot_us = dot_ms * 1000.0
+    char_space_us = 3 * dot_us if char_space_ms is None else char_space_ms * 1000.0
+    return {"1": [u * dot_us for u in ON_UNITS], "0": off_lengths(dot_us, char_space_us)}
+
+
+def station_timing(text):
+    """Parses CODE=DOT,SPACE (SPACE may be left out for the standard 3 dots)"""
+    try:
+        code, timing = text.split("=", 1)
+        parts = [float(t) for t in timing.split(",")]
+        if len(parts) not in (1, 2) or not code:
+            raise ValueError
+    except ValueError:
+        raise argparse.ArgumentTypeError("expected CODE=DOT_MS[,CHAR_SPACE_MS], not %r" % text)
+    return code, (parts[0], parts[1] if len(parts) == 2 else None)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--dot-ms", type=float, default=100.0, help="dot_time in milliseconds")
+    parser.add_argument("--char-space-ms", type=float, default=None,
+                        help="space between characters in milliseconds (default 3 dots)")
+    parser.add_argument("--station", type=station_timing, action="append", default=[],
+                        metavar="CODE=DOT,SPACE",
+                        help="dot and character space in milliseconds for one station's buzzer")
+    parser.add_argument("--tolerance-ms", type=float, default=5.0,
+                        help="report elements further than this from the nominal length")
+    parser.add_argument("vcd")
+    args = parser.parse_args()
+
+    default_timing = (args.dot_ms, args.char_space_ms)
+    overrides = dict((code + "_buzzer", timing) for code, timing in args.station)
+    timings = {}        # buzzer name -> (dot_ms, char_space_ms) from the trace header
+    lengths = {}        # buzzer name -> element_lengths()
+    names = {}          # VCD identifier -> buzzer name
+    last_edge = {}      # identifier -> (value, time)
+    worst = {}          # name -> (deviation_us, description)
+    counts = {}
+    failures = 0
+    now = 0
+
+    with open(args.vcd) as vcd:
+        for line in vcd:
+            words = line.split()
+            if not words:
+                continue
+            if words[0] == "$var" and len(words) > 4 and words[4].endswith("_buzzer"):
+                names[words[3]] = words[4]
+            elif words[0] == "$comment" and len(words) > 4 and words[1] == "timing":
+                fields = dict(w.split("=", 1) for w in words[3:] if "=" in w)
+                timings[words[2]] = (float(fields["dot_ms"]), float(fields["char_space_ms"]))
+            elif words[0].startswith("#"):
+                now = int(words[0][1:])
+            elif words[0][0] in "01" and words[0][1:] in names:
+                ident, value = words[0][1:], words[0][0]
+                prev = last_edge.get(ident)
+                last_edge[ident] = (value, now)
+                if prev is None or prev[0] == value:
+                    continue
+                name = names[ident]
+                if name not in lengths:
+                    timing = overrides.get(name, timings.get(name, default_timing))
+                    lengths[name] = (timing[0] * 1000.0, element_lengths(*timing))
+                dot_us, allowed = lengths[name][0], lengths[name][1][prev[0]]
+                length = now - prev[1]
+                if prev[0] == "0" and length > max(allowed) + dot_us:
+                    continue
+                nominal = min(allowed, key=lambda a: abs(length - a))
+                deviation = length - nominal
+                counts[name] = counts.get(name, 0) + 1
+                what = "%s of %.3f ms at %d us (nominal %.0f ms)" % (
+                    "on" if prev[0] == "1" else "off", length / 1000.0, prev[1], nominal / 1000.0)
+                if name not in worst or abs(deviation) > abs(worst[name][0]):
+                    worst[name] = (deviation, what)
+                if abs(deviation) > args.tolerance_ms * 1000.0:
+                    failures += 1
+                    print("%s: %s is off by %+.3f ms" % (name, what, deviation / 1000.0))
+
+    for name in sorted(worst):
+        deviation, what = worst[name]
+        print("%s: %d elements, worst deviation %+.3f ms (%s)" % (
+            name, counts[name], deviation / 1000.0, what))
+    if not worst:
+        # An empty or truncated capture has nothing wrong in it, but proves nothing either
+        print("%s: no buzzer elements to check" % args.vcd)
+        return 1
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,137 @@
+#!/usr/bin/env python3
+# make_sounder_samples.py -- generate the telegraph sounder samples for sounder.cpp
+#   Copyright (c) 2026, the station_buzzers contributors
+#
+# This program is free software; you can redistribute it and/or modify it under the terms of
+# the GNU General Public License as published by the Free Software Foundation; either version
+# 2 of the License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+# without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# See the GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License along with this program;
+# if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+# Boston, MA 02110-1301, USA.
+#
+# Writes sounder_samples.h: the "down" (armature striking the anvil) and "up" (armature hitting
+# the back stop) clicks of a railroad sounder, as 4-bit IMA ADPCM at the sample rate sounder.cpp
+# plays them. By default the clicks are synthesized as a noise burst plus a couple of damped
+# resonances; a recording can be used instead with --down and --up, given as mono 16-bit WAV
+# files at any rate.
+#
+# usage: make_sounder_samples.py [--down down.wav] [--up up.wav] > sounder_samples.h
+
+import argparse
+import math
+import random
+import struct
+import sys
+import wave
+
+SAMPLE_RATE = 16000000 / 510 / 4     # Timer2 phase-correct PWM, one sample every 4 periods
+
+STEP_TABLE = [
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66,
+    73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408,
+    449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630,
+    9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+    32767]
+INDEX_TABLE = [-1, -1, -1, -1, 2, 4, 6, 8]
+
+
+def synthesize(length_ms, partials, noise_ms, seed):
+    rng = random.Random(seed)
+    count = int(SAMPLE_RATE * length_ms / 1000)
+    out = []
+    for n in range(count):
+        t = n / SAMPLE_RATE
+        value = 0.0
+        for freq, decay_ms, level in partials:
+            value += level * math.exp(-t * 1000 / decay_ms) * math.sin(2 * math.pi * freq * t)
+        value += 0.6 * math.exp(-t * 1000 / noise_ms) * (rng.random() * 2 - 1)
+        out.append(int(max(-1.0, min(1.0, value)) * 24000))
+    return out
+
+
+def read_wav(path):
+    with wave.open(path) as wav:
+        if wav.getnchannels() != 1 or wav.getsampwidth() != 2:
+            sys.exit("%s: need a mono 16-bit WAV file" % path)
+        rate = wav.getframerate()
+        data = struct.unpack("<%dh" % wav.getnframes(), wav.readframes(wav.getnframes()))
+    count = int(len(data) * SAMPLE_RATE / rate)
+    return [data[min(len(data) - 1, int(n * rate / SAMPLE_RATE))] for n in range(count)]
+
+
+def encode(samples, start_index):
+    """IMA ADPCM, starting from a predictor of 0 and start_index, low nibble first"""
+    predictor, index, codes, error = 0, start_index, [], 0
+    for sample in samples:
+        step = STEP_TABLE[index]
+        diff = sample - predictor
+        code = 8 if diff < 0 else 0
+        diff = abs(diff)
+        if diff >= step:
+            code |= 4
+            diff -= step
+        if diff >= step >> 1:
+            code |= 2
+            diff -= step >> 1
+        if diff >= step >> 2:
+            code |= 1
+        # Track the decoder exactly, so that errors don't accumulate
+        delta = step >> 3
+        if code & 4:
+            delta += step
+        if code & 2:
+            delta += step >> 1
+        if code & 1:
+            delta += step >> 2
+        predictor = max(-32768, min(32767, predictor - delta if code & 8 else predictor + delta))
+        index = max(0, min(88, index + INDEX_TABLE[code & 7]))
+        codes.append(code)
+        error += (sample - predictor) ** 2
+    if len(codes) % 2:
+        codes.append(0)
+    return [codes[i] | (codes[i + 1] << 4) for i in range(0, len(codes), 2)], error
+
+
+def emit(name, samples, out):
+    # A click starts at full volume, so starting from the smallest step would lose its attack.
+    # Pick the starting step index that reproduces the sample best.
+    start_index = min(range(89), key=lambda i: encode(samples, i)[1])
+    data, error = encode(samples, start_index)
+    out.write("static const uint16_t %s_samples = %d;\n" % (name, len(samples)))
+    out.write("static const uint8_t %s_start_index = %d;\n" % (name, start_index))
+    out.write("static const uint8_t %s_adpcm[] PROGMEM = {\n" % name)
+    for i in range(0, len(data), 16):
+        out.write("  " + " ".join("0x%02x," % b for b in data[i:i + 16]) + "\n")
+    out.write("};\n\n")
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--down", help="mono 16-bit WAV of the down stroke")
+    parser.add_argument("--up", help="mono 16-bit WAV of the up stroke")
+    args = parser.parse_args()
+
+    down = read_wav(args.down) if args.down else synthesize(
+        40, [(1150, 9, 0.7), (2900, 4, 0.5), (420, 14, 0.4)], 3, 1)
+    up = read_wav(args.up) if args.up else synthesize(
+        28, [(1600, 6, 0.45), (3400, 3, 0.3)], 2, 2)
+
+    out = sys.stdout
+    out.write("// sounder_samples.h -- generated by tools/make_sounder_samples.py, do not edit\n")
+    out.write("//\n// 4-bit IMA ADPCM at %.1f Hz, low nibble first\n\n" % SAMPLE_RATE)
+    emit("sounder_down", down, out)
+    emit("sounder_up", up, out)
+    out.write("static const uint16_t adpcm_step_table[] PROGMEM = {\n")
+    for i in range(0, len(STEP_TABLE), 12):
+        out.write("  " + " ".join("%d," % s for s in STEP_TABLE[i:i + 12]) + "\n")
+    out.write("};\n")
+
+
+if __name__ == "__main__":
+    main()
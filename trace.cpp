@@ -0,0 +1,192 @@
+// trace.cpp -- optional VCD waveform trace of the stations for station_buzzers
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+#include "trace.h"
+#include "station_info.h"
+
+#ifdef WANT_VCD_TRACE
+
+#ifdef WANT_REAL_SERIAL
+#error "WANT_VCD_TRACE owns the serial port; disable WANT_REAL_SERIAL in DebugSerial.h"
+#endif
+
+static const unsigned long trace_baud_rate = 115200;
+
+// Each station gets four consecutive one-character VCD identifiers starting at '!', which
+// keeps every value change line down to a few bytes.
+enum Trace_Signal {
+  SIGNAL_BUZZER,
+  SIGNAL_CALLED,
+  SIGNAL_OFF_HOOK,
+  SIGNAL_STATE,
+  SIGNALS_PER_STATION
+};
+static const int trace_max_stations = 16;
+static const uint8_t value_unknown = 0xff;
+
+static bool          trace_started = false;
+static uint8_t       last_value[trace_max_stations][SIGNALS_PER_STATION];
+static unsigned long last_micros;
+static unsigned long micros_wraps;        // micros() wraps every 71 minutes; a layout with
+                                          // no activity at all for that long loses one
+static unsigned long written_micros;
+static unsigned long written_wraps;
+
+static inline char
+signal_id(int station_idx, uint8_t signal)
+{
+  return '!' + station_idx * SIGNALS_PER_STATION + signal;
+}
+
+static void
+write_var(const char *type, uint8_t width, int station_idx, uint8_t signal, const __FlashStringHelper *suffix)
+{
+  Serial.print(F("$var "));
+  Serial.print(type);
+  Serial.print(' ');
+  Serial.print(width);
+  Serial.print(' ');
+  Serial.print(signal_id(station_idx, signal));
+  Serial.print(' ');
+  Serial.print(stations[station_idx].station_code());
+  Serial.print(suffix);
+  Serial.println(F(" $end"));
+}
+
+static void
+write_timestamp()
+{
+  const unsigned long now_micros = micros();
+  if (now_micros < last_micros)
+    micros_wraps++;
+  last_micros = now_micros;
+  if ((now_micros == written_micros) && (micros_wraps == written_wraps))
+    return;
+  written_micros = now_micros;
+  written_wraps = micros_wraps;
+
+  // Print doesn't handle 64-bit numbers, so do the conversion here
+  uint64_t stamp = (static_cast<uint64_t>(micros_wraps) << 32) | now_micros;
+  char digits[21];
+  char *p = &digits[sizeof(digits) - 1];
+  *p = '\0';
+  do {
+    *--p = '0' + static_cast<char>(stamp % 10);
+    stamp /= 10;
+  } while (stamp != 0);
+  Serial.print('#');
+  Serial.println(p);
+}
+
+static void
+write_value(int station_idx, uint8_t signal, uint8_t value)
+{
+  if (signal == SIGNAL_STATE) {
+    Serial.print('b');
+    for (uint8_t mask = 0x4; mask != 0; mask >>= 1)
+      Serial.print((value == value_unknown) ? 'x' : ((value & mask) ? '1' : '0'));
+    Serial.print(' ');
+  } else {
+    Serial.print((value == value_unknown) ? 'x' : (value ? '1' : '0'));
+  }
+  Serial.println(signal_id(station_idx, signal));
+}
+
+static void
+trace_change(int station_idx, uint8_t signal, uint8_t value)
+{
+  if (!trace_started || (station_idx < 0) || (station_idx >= trace_max_stations))
+    return;
+  if (last_value[station_idx][signal] == value)
+    return;
+  last_value[station_idx][signal] = value;
+  write_timestamp();
+  write_value(station_idx, signal, value);
+}
+
+void
+trace_begin()
+{
+  const int traced = (num_stations < trace_max_stations) ? num_stations : trace_max_stations;
+
+  Serial.begin(trace_baud_rate);
+  Serial.println(F("$version station_buzzers $end"));
+  Serial.println(F("$timescale 1us $end"));
+  Serial.println(F("$scope module station_buzzers $end"));
+  for (int ii = 0; ii < traced; ii++) {
+    write_var("wire", 1, ii, SIGNAL_BUZZER,   F("_buzzer"));
+    write_var("wire", 1, ii, SIGNAL_CALLED,   F("_called"));
+    write_var("wire", 1, ii, SIGNAL_OFF_HOOK, F("_off_hook"));
+    write_var("reg",  3, ii, SIGNAL_STATE,    F("_state"));
+  }
+  Serial.println(F("$upscope $end"));
+
+  // Each buzzer's code speed, for tools/check_morse_vcd.py
+  for (int ii = 0; ii < traced; ii++) {
+    Serial.print(F("$comment timing "));
+    Serial.print(stations[ii].station_code());
+    Serial.print(F("_buzzer dot_ms="));
+    Serial.print(stations[ii].morse_.dot_time());
+    Serial.print(F(" char_space_ms="));
+    Serial.print(stations[ii].morse_.char_space_time());
+    Serial.println(F(" $end"));
+  }
+  Serial.println(F("$enddefinitions $end"));
+
+  // Everything starts out unknown, except the states which init_station_states() has set
+  last_micros = written_micros = micros();
+  Serial.print('#');
+  Serial.println(last_micros);
+  Serial.println(F("$dumpvars"));
+  for (int ii = 0; ii < traced; ii++) {
+    for (uint8_t signal = 0; signal < SIGNALS_PER_STATION; signal++) {
+      last_value[ii][signal] = (signal == SIGNAL_STATE) ? stations[ii].state() : value_unknown;
+      write_value(ii, signal, last_value[ii][signal]);
+    }
+  }
+  Serial.println(F("$end"));
+  trace_started = true;
+}
+
+void
+trace_buzzer(uint8_t pin, bool on)
+{
+  for (int ii = 0; ii < num_stations; ii++) {
+    if (stations[ii].buzzer_pin_ == pin) {
+      trace_change(ii, SIGNAL_BUZZER, on);
+      return;
+    }
+  }
+}
+
+void
+trace_called(int station_idx, bool called)
+{
+  trace_change(station_idx, SIGNAL_CALLED, called);
+}
+
+void
+trace_off_hook(int station_idx, bool off_hook)
+{
+  trace_change(station_idx, SIGNAL_OFF_HOOK, off_hook);
+}
+
+void
+trace_state(int station_idx, uint8_t state)
+{
+  trace_change(station_idx, SIGNAL_STATE, state);
+}
+
+#endif
@@ -0,0 +1,47 @@
+// trace.h -- optional VCD waveform trace of the stations for station_buzzers
+//   Copyright (c) 2026, the station_buzzers contributors
+//
+// This program is free software; you can redistribute it and/or modify it under the terms of
+// the GNU General Public License as published by the Free Software Foundation; either version
+// 2 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program;
+// if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+// Boston, MA 02110-1301, USA.
+
+#ifndef INCLUDED_trace
+#define INCLUDED_trace
+
+#include <Arduino.h>
+#include "DebugSerial.h"
+
+// With WANT_VCD_TRACE enabled in DebugSerial.h, the sketch writes an IEEE 1364 VCD ("value change
+// dump") file to the serial port at trace_baud_rate. Each station has a buzzer, called and
+// off_hook wire plus a 3-bit state register, and times are in microseconds. Every change is
+// written as it happens, so a run of any length can be captured to disk with a serial terminal
+// and opened in GTKWave or any other waveform viewer. tools/check_morse_vcd.py checks the buzzer
+// timing in such a capture against the Morse element lengths, using each buzzer's dot and
+// character space as written in a "$comment timing" line of the header.
+#ifdef WANT_VCD_TRACE
+
+void trace_begin();
+void trace_buzzer(uint8_t pin, bool on);
+void trace_called(int station_idx, bool called);
+void trace_off_hook(int station_idx, bool off_hook);
+void trace_state(int station_idx, uint8_t state);
+
+#else
+
+inline void trace_begin() { }
+inline void trace_buzzer(uint8_t pin, bool on) { }
+inline void trace_called(int station_idx, bool called) { }
+inline void trace_off_hook(int station_idx, bool off_hook) { }
+inline void trace_state(int station_idx, uint8_t state) { }
+
+#endif
+
+#endif